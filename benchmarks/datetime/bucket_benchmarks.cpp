@@ -0,0 +1,71 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <date/date.h>
+#include <stuff/datetime/bucket.h>
+#include <stuff/datetime/datetime.h>
+#include <stuff/datetime/zone.h>
+#include <vector>
+
+using namespace stuff::datetime;
+using namespace std::chrono_literals;
+
+TEST_CASE("floor times to buckets", "[datetime_benchmarks]")
+{
+    // a day of ticks 10ms apart
+    const sys_time        start = date::floor<date::days>(current_time());
+    std::vector<sys_time> times;
+    for (auto t = start; t < start + 24h; t += 10ms) {
+        times.push_back(t);
+    }
+    std::vector<sys_time> starts(times.size());
+
+    BENCHMARK("date::floor (5 minutes)")
+    {
+        for (std::size_t k = 0; k < times.size(); ++k) {
+            const auto minutes = date::floor<std::chrono::minutes>(times[k]);
+            starts[k] = minutes - minutes.time_since_epoch() % 5;
+        }
+        return starts.back();
+    };
+
+    BENCHMARK("stuff::datetime::floor_times (5 minutes)")
+    {
+        floor_times(times.data(), times.size(), 5min, starts.data());
+        return starts.back();
+    };
+
+    BENCHMARK("stuff::datetime::floor_times (days in new york)")
+    {
+        floor_times(times.data(), times.size(), calendar_interval::day,
+            nyc_fast_zone(), starts.data());
+        return starts.back();
+    };
+
+    std::vector<double> prices(times.size(), 100.0);
+    std::vector<double> volumes(times.size(), 1.0);
+
+    BENCHMARK("stuff::datetime::ohlcv_resampler (1 minute)")
+    {
+        ohlcv_resampler resampler {1min};
+        std::size_t     bars = 0;
+        resampler.add(times.data(), prices.data(), volumes.data(),
+            times.size(), [&](const ohlcv_bar&) { ++bars; });
+        return bars;
+    };
+}
@@ -0,0 +1,80 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <date/date.h>
+#include <date/tz.h>
+#include <memory>
+#include <stuff/datetime/calendar.h>
+#include <stuff/datetime/datetime.h>
+#include <vector>
+
+using namespace stuff::datetime;
+using namespace std::chrono_literals;
+
+TEST_CASE("check trading sessions", "[datetime_benchmarks]")
+{
+    const trading_calendar nyse {
+        {"XNYS", "America/New_York", {{9h + 30min, 16h}}}, date::year {2000},
+        date::year {2040}};
+
+    // a tick every 10 seconds for ~2 weeks
+    const auto            now = current_time();
+    std::vector<sys_time> ticks;
+    for (int i = 0; i < 100000; ++i) {
+        ticks.push_back(now + std::chrono::seconds(10 * i));
+    }
+
+    BENCHMARK("date::make_zoned")
+    {
+        std::size_t open = 0;
+        for (auto t : ticks) {
+            const auto local = date::make_zoned(nyc_tz(), t).get_local_time();
+            const auto day   = date::floor<date::days>(local);
+            const auto time  = local - day;
+            const date::weekday weekday {day};
+            open += weekday != date::Saturday && weekday != date::Sunday
+                    && time >= 9h + 30min && time < 16h;
+        }
+        return open;
+    };
+
+    BENCHMARK("stuff::datetime::trading_calendar::is_open")
+    {
+        std::size_t open = 0;
+        for (auto t : ticks) {
+            open += nyse.is_open(t);
+        }
+        return open;
+    };
+
+    auto open = std::make_unique<bool[]>(ticks.size());
+    BENCHMARK("stuff::datetime::trading_calendar::classify")
+    {
+        nyse.classify(ticks.data(), ticks.size(), open.get());
+        return open[0];
+    };
+
+    BENCHMARK("stuff::datetime::trading_calendar::duration_between")
+    {
+        duration total {0};
+        for (std::size_t i = 1; i < ticks.size(); ++i) {
+            total += nyse.duration_between(ticks[i - 1], ticks[i]);
+        }
+        return total;
+    };
+}
@@ -20,6 +20,7 @@
 #include <stuff/datetime/conversions.h>
 #include <stuff/datetime/datetime.h>
 #include <stuff/string/split.h>
+#include <vector>
 
 using namespace stuff::container;
 using namespace stuff::datetime;
@@ -32,6 +33,45 @@ TEST_CASE("convert a date to a string", "[datetime_benchmarks]")
     BENCHMARK("date::format") { return date::format("%FT%TZ", now); };
 
     BENCHMARK("stuff::datetime::to_string") { return to_string(now); };
+
+    char buf[sys_time_size];
+    BENCHMARK("stuff::datetime::format_to") { return format_to(buf, now); };
+}
+
+TEST_CASE("convert dates to a column of strings", "[datetime_benchmarks]")
+{
+    std::vector<sys_time> times;
+    auto                  t = to_sys_time("2015-03-14T15:09:26.535897932Z");
+    for (int i = 0; i < 10000; ++i) {
+        times.push_back(t);
+        t += std::chrono::milliseconds {1234567};
+    }
+    std::string column(times.size() * sys_time_size, ' ');
+
+    BENCHMARK("stuff::datetime::to_string")
+    {
+        column.clear();
+        for (auto time : times) {
+            column += to_string(time);
+        }
+        return column.size();
+    };
+
+    BENCHMARK("stuff::datetime::time_converter::to_string")
+    {
+        time_converter converter;
+        column.clear();
+        for (auto time : times) {
+            column += converter.to_string(time);
+        }
+        return column.size();
+    };
+
+    BENCHMARK("stuff::datetime::format_to")
+    {
+        column.resize(times.size() * sys_time_size);
+        return format_to(column.data(), times.data(), times.size());
+    };
 }
 
 TEST_CASE("convert a date string to a date", "[datetime_benchmarks]")
@@ -56,3 +96,97 @@ TEST_CASE("convert a date string to a date", "[datetime_benchmarks]")
         return to_sys_time(stok.next('\n'));
     };
 }
+
+TEST_CASE("convert a variable-width date string to a date",
+    "[datetime_benchmarks]")
+{
+    // not the fixed layout, so to_sys_time() tokenizes it
+    std::string datestr {"2015-03-14T15:09:26.535Z"};
+
+    BENCHMARK("date::parse")
+    {
+        std::stringstream ss {datestr};
+        sys_time          t;
+        ss >> date::parse("%FT%TZ", t);
+        return t;
+    };
+
+    BENCHMARK("stuff::to_sys_time") { return to_sys_time(datestr); };
+}
+
+TEST_CASE("convert a column of date strings to dates", "[datetime_benchmarks]")
+{
+    std::vector<std::string> strs;
+    auto                     t = to_sys_time("2015-03-14T15:09:26.535897932Z");
+    for (int i = 0; i < 10000; ++i) {
+        strs.push_back(to_string(t));
+        t += std::chrono::milliseconds {1234567};
+    }
+    std::vector<std::string_view> views {strs.begin(), strs.end()};
+    std::vector<sys_time>         times(views.size());
+
+    BENCHMARK("stuff::to_sys_time")
+    {
+        for (std::size_t i = 0; i < views.size(); ++i) {
+            times[i] = to_sys_time(views[i]);
+        }
+        return times.back();
+    };
+
+    BENCHMARK("stuff::to_sys_times")
+    {
+        to_sys_times(views.data(), views.size(), times.data());
+        return times.back();
+    };
+
+    BENCHMARK("stuff::time_converter::to_sys_time")
+    {
+        time_converter converter;
+        for (std::size_t i = 0; i < views.size(); ++i) {
+            times[i] = converter.to_sys_time(views[i]);
+        }
+        return times.back();
+    };
+}
+
+TEST_CASE("convert a bad date string to a date", "[datetime_benchmarks]")
+{
+    std::string datestr {"2015-03-14T15:09:2x.535897932Z"};
+
+    BENCHMARK("stuff::to_sys_time")
+    {
+        try {
+            return to_sys_time(datestr);
+        }
+        catch (const datetime_error&) {
+            return sys_time {};
+        }
+    };
+
+    BENCHMARK("stuff::try_to_sys_time")
+    { return try_to_sys_time(datestr).value; };
+}
+
+TEST_CASE("parse a record with a time", "[datetime_benchmarks]")
+{
+    std::string line {"2015-03-14T15:09:26.535897932Z,EUR/USD,1.08231,1.08234,"
+                      "1000000"};
+
+    using record =
+        std::tuple<sys_time, std::string_view, double, double, long>;
+
+    BENCHMARK("string_tokenizer + to_number")
+    {
+        string_tokenizer stok {line};
+        record           r;
+        std::get<0>(r) = to_sys_time(stok.next(','));
+        std::get<1>(r) = stok.next(',');
+        std::get<2>(r) = to_number<double>(stok.next(','));
+        std::get<3>(r) = to_number<double>(stok.next(','));
+        std::get<4>(r) = to_number<long>(stok.next(','));
+        return r;
+    };
+
+    BENCHMARK("stuff::string::parse_record")
+    { return parse_record<record>(line, ',').value; };
+}
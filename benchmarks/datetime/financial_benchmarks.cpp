@@ -0,0 +1,63 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <date/date.h>
+#include <stuff/datetime/datetime.h>
+#include <stuff/datetime/financial.h>
+#include <memory>
+#include <vector>
+
+using namespace stuff::datetime;
+
+TEST_CASE("check forex sessions", "[datetime_benchmarks]")
+{
+    const forex_calendar calendar {date::year {2000}, date::year {2040}};
+
+    // a tick every 10 seconds for ~2 weeks
+    const auto            now = current_time();
+    std::vector<sys_time> ticks;
+    for (int i = 0; i < 100000; ++i) {
+        ticks.push_back(now + std::chrono::seconds(10 * i));
+    }
+
+    BENCHMARK("stuff::datetime::get_forex_bells")
+    {
+        std::size_t open = 0;
+        for (auto t : ticks) {
+            const auto bells = get_forex_bells(t);
+            open += t >= bells.open && t < bells.close;
+        }
+        return open;
+    };
+
+    BENCHMARK("stuff::datetime::forex_calendar::is_open")
+    {
+        std::size_t open = 0;
+        for (auto t : ticks) {
+            open += calendar.is_open(t);
+        }
+        return open;
+    };
+
+    auto open = std::make_unique<bool[]>(ticks.size());
+    BENCHMARK("stuff::datetime::forex_calendar::classify")
+    {
+        calendar.classify(ticks.data(), ticks.size(), open.get());
+        return open[0];
+    };
+}
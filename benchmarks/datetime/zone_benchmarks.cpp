@@ -0,0 +1,57 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <date/date.h>
+#include <date/tz.h>
+#include <stuff/datetime/datetime.h>
+#include <stuff/datetime/financial.h>
+#include <stuff/datetime/zone.h>
+
+using namespace stuff::datetime;
+
+TEST_CASE("convert a time to and from new york", "[datetime_benchmarks]")
+{
+    const auto  now   = current_time();
+    const auto  local = date::make_zoned(nyc_tz(), now).get_local_time();
+    const auto& nyc   = nyc_fast_zone();
+
+    BENCHMARK("date::make_zoned (to local)")
+    {
+        return date::make_zoned(nyc_tz(), now).get_local_time();
+    };
+
+    BENCHMARK("stuff::datetime::fast_zone::to_local")
+    {
+        return nyc.to_local(now);
+    };
+
+    BENCHMARK("date::make_zoned (to sys)")
+    {
+        return date::make_zoned(nyc_tz(), local).get_sys_time();
+    };
+
+    BENCHMARK("stuff::datetime::fast_zone::to_sys")
+    {
+        return nyc.to_sys(local);
+    };
+
+    BENCHMARK("stuff::datetime::get_forex_bells")
+    {
+        return get_forex_bells(now);
+    };
+}
@@ -0,0 +1,89 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cctype>
+#include <string>
+#include <stuff/string/ascii.h>
+
+using namespace stuff::string;
+
+TEST_CASE("trim whitespace", "[string_benchmarks]")
+{
+    std::string field {"   1.08231   "};
+
+    BENCHMARK("std::isspace")
+    {
+        auto is_space = [](char c) {
+            return std::isspace(static_cast<unsigned char>(c)) != 0;
+        };
+        auto first = std::find_if_not(field.begin(), field.end(), is_space);
+        auto last =
+            std::find_if_not(field.rbegin(), field.rend(), is_space).base();
+        return first < last ? last - first : 0;
+    };
+
+    BENCHMARK("stuff::string::trim") { return trim(field).size(); };
+}
+
+TEST_CASE("convert to upper case", "[string_benchmarks]")
+{
+    std::string symbol {"eur/usd"};
+    std::string line(256, 'x');
+
+    BENCHMARK("std::toupper (symbol)")
+    {
+        std::transform(symbol.begin(), symbol.end(), symbol.begin(),
+            [](char c) { return std::toupper(static_cast<unsigned char>(c)); });
+        return symbol[0];
+    };
+
+    BENCHMARK("stuff::string::to_upper_ascii (symbol)")
+    {
+        to_upper_ascii(symbol);
+        return symbol[0];
+    };
+
+    BENCHMARK("std::toupper (line)")
+    {
+        std::transform(line.begin(), line.end(), line.begin(),
+            [](char c) { return std::toupper(static_cast<unsigned char>(c)); });
+        return line[0];
+    };
+
+    BENCHMARK("stuff::string::to_upper_ascii (line)")
+    {
+        to_upper_ascii(line);
+        return line[0];
+    };
+}
+
+TEST_CASE("check for digits", "[string_benchmarks]")
+{
+    std::string field {"20200314150926535"};
+
+    BENCHMARK("std::isdigit")
+    {
+        return std::all_of(field.begin(), field.end(), [](char c) {
+            return std::isdigit(static_cast<unsigned char>(c)) != 0;
+        });
+    };
+
+    BENCHMARK("stuff::string::all_of_class")
+    { return all_of_class(field, char_class::digit); };
+}
@@ -20,8 +20,12 @@
 #include <boost/convert/spirit.hpp>
 #include <boost/convert/strtol.hpp>
 #include <catch2/catch.hpp>
+#include <charconv>
+#include <fmt/format.h>
 #include <string>
 #include <stuff/string/convert.h>
+#include <stuff/string/split.h>
+#include <vector>
 
 using namespace stuff::string;
 
@@ -52,7 +56,14 @@ TEST_CASE("convert strings to integers", "[string_benchmarks]")
         return boost::convert<long>(str, cnv).value();
     };
 
-    BENCHMARK("stuff::core::to_number")
+    BENCHMARK("std::from_chars")
+    {
+        long result {};
+        std::from_chars(str.data(), str.data() + str.size(), result);
+        return result;
+    };
+
+    BENCHMARK("stuff::string::to_number")
     { return to_number<long>(str, 0); };
 }
 
@@ -83,6 +94,43 @@ TEST_CASE("convert strings to doubles", "[string_benchmarks]")
         return boost::convert<double>(str, cnv).value();
     };
 
-    BENCHMARK("stuff::core::to_number")
+    BENCHMARK("stuff::string::to_number")
     { return to_number<double>(str, 0); };
+
+    BENCHMARK("stuff::string::to_fixed")
+    { return to_fixed<long, 10>(str, 0); };
+}
+
+TEST_CASE("convert a column of strings", "[string_benchmarks]")
+{
+    std::string column;
+    for (int i = 0; i < 1000; ++i) {
+        column += fmt::format("{}.{:04d}\n", 1000 + i, i * 7);
+    }
+    column.pop_back();
+
+    std::vector<std::string_view> views;
+    split_string(column, '\n', views);
+    std::vector<double> numbers(views.size());
+
+    BENCHMARK("stuff::string::to_number (loop)")
+    {
+        for (size_t i = 0; i < views.size(); ++i) {
+            numbers[i] = to_number<double>(views[i], 0);
+        }
+        return numbers.back();
+    };
+
+    BENCHMARK("stuff::string::to_numbers")
+    {
+        to_numbers(views.begin(), views.end(), numbers.begin(), 0.0);
+        return numbers.back();
+    };
+
+    BENCHMARK("stuff::string::to_numbers (delimited)")
+    {
+        numbers.clear();
+        to_numbers(column, '\n', 0.0, numbers);
+        return numbers.back();
+    };
 }
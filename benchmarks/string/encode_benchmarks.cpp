@@ -0,0 +1,57 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <string>
+#include <stuff/string/encode.h>
+#include <stuff/string/hash.h>
+
+using namespace stuff::string;
+
+namespace {
+
+    std::string make_data(std::size_t n)
+    {
+        std::string data;
+        for (std::size_t i = 0; i < n; ++i) {
+            data.push_back(static_cast<char>(i * 31 + 7));
+        }
+        return data;
+    }
+
+} // namespace
+
+TEST_CASE("encode 64 KiB", "[string_benchmarks]")
+{
+    const auto data   = make_data(1 << 16);
+    const auto hex    = to_hex(data);
+    const auto base64 = to_base64(data);
+
+    BENCHMARK("stuff::string::to_hex") { return to_hex(data); };
+    BENCHMARK("stuff::string::from_hex") { return from_hex(hex); };
+    BENCHMARK("stuff::string::to_base64") { return to_base64(data); };
+    BENCHMARK("stuff::string::from_base64") { return from_base64(base64); };
+}
+
+TEST_CASE("hash 64 KiB", "[string_benchmarks]")
+{
+    const auto data = make_data(1 << 16);
+
+    BENCHMARK("std::hash") { return std::hash<std::string> {}(data); };
+    BENCHMARK("stuff::string::hash64") { return hash64(data); };
+    BENCHMARK("stuff::string::crc32c") { return crc32c(data); };
+}
@@ -0,0 +1,76 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <charconv>
+#include <fmt/format.h>
+#include <string>
+#include <stuff/string/format.h>
+
+using namespace stuff::string;
+
+TEST_CASE("convert integers to strings", "[string_benchmarks]")
+{
+    long value {1234567890};
+    char buffer[max_number_size<long>];
+
+    BENCHMARK("std::to_string") { return std::to_string(value); };
+
+    BENCHMARK("fmt::format") { return fmt::format("{}", value); };
+
+    BENCHMARK("std::to_chars")
+    { return std::to_chars(buffer, buffer + sizeof(buffer), value).ptr; };
+
+    BENCHMARK("stuff::string::format_number")
+    { return format_number(buffer, value); };
+}
+
+TEST_CASE("convert doubles to strings", "[string_benchmarks]")
+{
+    double value {1.2345678901};
+    char   buffer[64];
+
+    BENCHMARK("fmt::format") { return fmt::format("{}", value); };
+
+    BENCHMARK("fmt::format (fixed)") { return fmt::format("{:.5f}", value); };
+
+    BENCHMARK("stuff::string::format_number")
+    { return format_number(buffer, value); };
+
+    BENCHMARK("stuff::string::format_fixed")
+    { return format_fixed(buffer, buffer + sizeof(buffer), value, 5); };
+}
+
+TEST_CASE("build a line of output", "[string_benchmarks]")
+{
+    output_buffer out;
+
+    BENCHMARK("fmt::format")
+    {
+        return fmt::format("{},{},{:.5f},{}", "EUR/USD", 1234567890L, 1.08231,
+            1000000L);
+    };
+
+    BENCHMARK("stuff::string::output_buffer")
+    {
+        out.clear();
+        out.append("EUR/USD").append(',').append_number(1234567890L);
+        out.append(',').append_fixed(1.08231, 5).append(',');
+        out.append_number(1000000L);
+        return out.size();
+    };
+}
@@ -0,0 +1,54 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include <string>
+#include <stuff/string/match.h>
+#include <stuff/string/split.h>
+#include <unordered_set>
+#include <vector>
+
+using namespace stuff::string;
+
+TEST_CASE("filter lines by symbol", "[string_benchmarks]")
+{
+    // a few hundred symbols, but the line has none of them
+    std::vector<std::string> symbols;
+    for (int i = 0; i < 300; ++i) {
+        symbols.push_back(fmt::format("SYM{:03}/USD", i));
+    }
+    std::unordered_set<std::string_view> symbol_set {
+        symbols.begin(), symbols.end()};
+    multi_matcher matcher {symbols.begin(), symbols.end()};
+
+    std::string line {"2015-03-14T15:09:26.535897932Z,1.08231,1.08234,1000000,"
+                      "2000000,EBS,EUR/USD"};
+
+    BENCHMARK("split_view + std::unordered_set")
+    {
+        for (auto field : split_view(line, ',')) {
+            if (symbol_set.count(field) != 0) {
+                return true;
+            }
+        }
+        return false;
+    };
+
+    BENCHMARK("stuff::string::multi_matcher")
+    { return matcher.contains(line); };
+}
@@ -0,0 +1,165 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <atomic>
+#include <catch2/catch.hpp>
+#include <cstdlib>
+#include <fmt/format.h>
+#include <new>
+#include <string>
+#include <stuff/string/split.h>
+
+using namespace stuff::container;
+using namespace stuff::string;
+
+//
+// Count heap allocations so the benchmarks below can report allocations per
+// line for each way of splitting a string.
+//
+static std::atomic<size_t> allocation_count {0};
+
+void* operator new(std::size_t size)
+{
+    ++allocation_count;
+    if (void* p = std::malloc(size)) {
+        return p;
+    }
+    throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+
+template <typename Function>
+double allocations_per_line(Function f)
+{
+    constexpr size_t lines = 1000;
+
+    f(); // warm-up (e.g., so reused arrays reach their steady-state capacity)
+    auto before = allocation_count.load();
+    for (size_t i = 0; i < lines; ++i) {
+        f();
+    }
+    return static_cast<double>(allocation_count.load() - before) / lines;
+}
+
+TEST_CASE("split a line into fields", "[string_benchmarks]")
+{
+    std::string line {"2015-03-14T15:09:26.535897932Z,EUR/USD,1.08231,1.08234,"
+                      "1000000,2000000,EBS"};
+
+    string_view_array       reused;
+    small_string_view_array small;
+
+    auto by_function = [&line]() {
+        size_t count = 0;
+        split_string(line, ',', [&count](std::string_view) { ++count; });
+        return count;
+    };
+    auto by_view = [&line]() {
+        size_t count = 0;
+        for (auto field : split_view(line, ',')) {
+            count += field.size();
+        }
+        return count;
+    };
+    auto by_value    = [&line]() { return split_string(line, ',').size(); };
+    auto into_reused = [&line, &reused]() {
+        split_string(line, ',', reused);
+        return reused.size();
+    };
+    auto into_small = [&line, &small]() {
+        split_string(line, ',', small);
+        return small.size();
+    };
+
+    fmt::print("allocations per line:\n");
+    fmt::print("  split_string w/ f()           {}\n",
+        allocations_per_line(by_function));
+    fmt::print(
+        "  split_view                    {}\n", allocations_per_line(by_view));
+    fmt::print(
+        "  split_string                  {}\n", allocations_per_line(by_value));
+    fmt::print("  split_string w/ reused array  {}\n",
+        allocations_per_line(into_reused));
+    fmt::print("  split_string w/ small array   {}\n",
+        allocations_per_line(into_small));
+
+    BENCHMARK("split_string w/ f()") { return by_function(); };
+    BENCHMARK("split_view") { return by_view(); };
+    BENCHMARK("split_string") { return by_value(); };
+    BENCHMARK("split_string w/ reused array") { return into_reused(); };
+    BENCHMARK("split_string w/ small array") { return into_small(); };
+}
+
+TEST_CASE(
+    "split a line with a multi-character separator", "[string_benchmarks]")
+{
+    std::string line;
+    for (int i = 0; i < 20; ++i) {
+        line += fmt::format("field number {}||", i);
+    }
+
+    BENCHMARK("std::string::find")
+    {
+        size_t count = 0;
+        size_t start = 0;
+        for (auto pos = line.find("||"); pos != std::string::npos;
+             pos      = line.find("||", start)) {
+            count += pos - start;
+            start = pos + 2;
+        }
+        return count;
+    };
+
+    string_separator sep {"||"};
+    BENCHMARK("string_tokenizer w/ string_separator")
+    {
+        size_t           count = 0;
+        string_tokenizer stok {line};
+        do {
+            count += stok.next(sep).size();
+        } while (stok);
+        return count;
+    };
+}
+
+TEST_CASE("find a column of a wide line", "[string_benchmarks]")
+{
+    std::string line;
+    for (int i = 0; i < 40; ++i) {
+        line += fmt::format("{},", 1.08231 + i);
+    }
+    line.pop_back();
+
+    BENCHMARK("string_tokenizer::next")
+    {
+        string_tokenizer stok {line};
+        for (int i = 0; i < 37; ++i) {
+            stok.next(',');
+        }
+        return stok.next(',');
+    };
+
+    BENCHMARK("string_tokenizer::field")
+    {
+        string_tokenizer stok {line};
+        return stok.field(37, ',');
+    };
+
+    BENCHMARK("nth_field") { return nth_field(line, ',', 37); };
+}
@@ -0,0 +1,320 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef STUFF_CONTAINER_PACKED_STRING_ARRAY_H
+#define STUFF_CONTAINER_PACKED_STRING_ARRAY_H
+
+#include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+namespace stuff::container {
+
+    //
+    // Array of strings stored back-to-back in one buffer.
+    //
+    // A string_array (std::vector<std::string>) costs a std::string (32 bytes)
+    // per element plus a heap allocation for each string too long for the
+    // small-string buffer. Here, the characters of all strings live in one
+    // growable buffer and each element only costs an offset (8 bytes), so
+    // large columns of strings take much less memory and scanning them is
+    // cache-friendly. Elements are read as std::string_view and can only be
+    // appended (i.e., this is built for loading and scanning data).
+    //
+    // Views returned by this class are invalidated by push_back() (as the
+    // buffer may move) and clear().
+    //
+    class packed_string_array {
+    public:
+        using value_type = std::string_view;
+        using size_type  = std::size_t;
+
+        //
+        // Iterator over the elements (as std::string_view). It is a proxy
+        // iterator: dereferencing makes a view (there is no string_view in
+        // the array to refer to), so it is only an input iterator to the
+        // standard library (i.e., iterator_category), but it has all of the
+        // operations of a random-access iterator (i.e., iterator_concept, as
+        // C++20 ranges see it).
+        //
+        class const_iterator {
+        public:
+            // what operator->() returns: the view, kept alive for ->
+            class arrow_proxy {
+            public:
+                explicit arrow_proxy(std::string_view view) noexcept
+                : m_view {view}
+                {
+                }
+
+                [[nodiscard]] inline const std::string_view*
+                operator->() const noexcept
+                {
+                    return &m_view;
+                }
+
+            private:
+                std::string_view m_view;
+
+            }; // class arrow_proxy
+
+            using iterator_category = std::input_iterator_tag;
+            using iterator_concept  = std::random_access_iterator_tag;
+            using value_type        = std::string_view;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = arrow_proxy;
+            using reference         = std::string_view;
+
+            const_iterator() noexcept = default;
+            const_iterator(
+                const packed_string_array* array, size_type index) noexcept
+            : m_array {array}, m_index {index}
+            {
+            }
+
+            [[nodiscard]] inline reference operator*() const noexcept
+            {
+                return (*m_array)[m_index];
+            }
+            [[nodiscard]] inline pointer operator->() const noexcept
+            {
+                return arrow_proxy {**this};
+            }
+            [[nodiscard]] inline reference operator[](
+                difference_type n) const noexcept
+            {
+                return (*m_array)[m_index + n];
+            }
+
+            inline const_iterator& operator++() noexcept
+            {
+                ++m_index;
+                return *this;
+            }
+            inline const_iterator operator++(int) noexcept
+            {
+                return const_iterator {m_array, m_index++};
+            }
+            inline const_iterator& operator--() noexcept
+            {
+                --m_index;
+                return *this;
+            }
+            inline const_iterator operator--(int) noexcept
+            {
+                return const_iterator {m_array, m_index--};
+            }
+            inline const_iterator& operator+=(difference_type n) noexcept
+            {
+                m_index += n;
+                return *this;
+            }
+            inline const_iterator& operator-=(difference_type n) noexcept
+            {
+                m_index -= n;
+                return *this;
+            }
+
+            [[nodiscard]] friend inline const_iterator operator+(
+                const_iterator it, difference_type n) noexcept
+            {
+                return it += n;
+            }
+            [[nodiscard]] friend inline const_iterator operator+(
+                difference_type n, const_iterator it) noexcept
+            {
+                return it += n;
+            }
+            [[nodiscard]] friend inline const_iterator operator-(
+                const_iterator it, difference_type n) noexcept
+            {
+                return it -= n;
+            }
+            [[nodiscard]] friend inline difference_type operator-(
+                const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return static_cast<difference_type>(lhs.m_index)
+                       - static_cast<difference_type>(rhs.m_index);
+            }
+
+            [[nodiscard]] friend inline bool operator==(
+                const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_index == rhs.m_index;
+            }
+            [[nodiscard]] friend inline bool operator!=(
+                const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_index != rhs.m_index;
+            }
+            [[nodiscard]] friend inline bool operator<(
+                const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_index < rhs.m_index;
+            }
+            [[nodiscard]] friend inline bool operator>(
+                const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_index > rhs.m_index;
+            }
+            [[nodiscard]] friend inline bool operator<=(
+                const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_index <= rhs.m_index;
+            }
+            [[nodiscard]] friend inline bool operator>=(
+                const const_iterator& lhs, const const_iterator& rhs) noexcept
+            {
+                return lhs.m_index >= rhs.m_index;
+            }
+
+        private:
+            const packed_string_array* m_array {nullptr};
+            size_type                  m_index {0};
+
+        }; // class const_iterator
+
+        using iterator = const_iterator;
+
+        packed_string_array() = default;
+
+        packed_string_array(const packed_string_array&) = default;
+        packed_string_array& operator=(const packed_string_array&) = default;
+
+        // a moved-from array is empty (and can be used again)
+        packed_string_array(packed_string_array&& other) noexcept
+        : m_chars {std::move(other.m_chars)},
+          m_offsets {std::move(other.m_offsets)}
+        {
+            other.clear();
+        }
+
+        // the moved-from array gets the memory of this one (and is empty)
+        packed_string_array& operator=(packed_string_array&& other) noexcept
+        {
+            m_chars.swap(other.m_chars);
+            m_offsets.swap(other.m_offsets);
+            other.clear();
+            return *this;
+        }
+
+        ~packed_string_array() = default;
+
+        //
+        // Append a copy of view.
+        //
+        inline void push_back(std::string_view view)
+        {
+            if (m_offsets.empty()) {
+                m_offsets.push_back(0);
+            }
+            m_chars.insert(m_chars.end(), view.begin(), view.end());
+            m_offsets.push_back(m_chars.size());
+        }
+
+        //
+        // Access an element; at() checks the index and throws
+        // std::out_of_range.
+        //
+        [[nodiscard]] inline std::string_view operator[](
+            size_type i) const noexcept
+        {
+            return std::string_view {
+                m_chars.data() + m_offsets[i], m_offsets[i + 1] - m_offsets[i]};
+        }
+        [[nodiscard]] inline std::string_view at(size_type i) const
+        {
+            if (i >= size()) {
+                throw std::out_of_range {"packed_string_array::at"};
+            }
+            return (*this)[i];
+        }
+        [[nodiscard]] inline std::string_view front() const noexcept
+        {
+            return (*this)[0];
+        }
+        [[nodiscard]] inline std::string_view back() const noexcept
+        {
+            return (*this)[size() - 1];
+        }
+
+        [[nodiscard]] inline const_iterator begin() const noexcept
+        {
+            return const_iterator {this, 0};
+        }
+        [[nodiscard]] inline const_iterator end() const noexcept
+        {
+            return const_iterator {this, size()};
+        }
+
+        //
+        // Number of strings and the total number of characters in them.
+        //
+        [[nodiscard]] inline size_type size() const noexcept
+        {
+            return m_offsets.empty() ? 0 : m_offsets.size() - 1;
+        }
+        [[nodiscard]] inline bool empty() const noexcept
+        {
+            return m_offsets.size() <= 1;
+        }
+        [[nodiscard]] inline size_type bytes() const noexcept
+        {
+            return m_chars.size();
+        }
+
+        //
+        // Reserve memory for count strings with a total of bytes characters.
+        //
+        inline void reserve(size_type count, size_type bytes)
+        {
+            m_offsets.reserve(count + 1);
+            m_chars.reserve(bytes);
+        }
+
+        //
+        // Remove all strings, but keep the memory (i.e., this is cheap).
+        //
+        inline void clear() noexcept
+        {
+            m_chars.clear();
+            m_offsets.clear();
+        }
+
+        inline void shrink_to_fit()
+        {
+            m_chars.shrink_to_fit();
+            m_offsets.shrink_to_fit();
+        }
+
+    private:
+        //
+        // Element i is m_chars[m_offsets[i], m_offsets[i + 1]). The leading 0
+        // is only added by the first push_back(), so an empty array (e.g.,
+        // a new or moved-from one) owns no memory and moves cannot throw.
+        //
+        std::vector<char>      m_chars;
+        std::vector<size_type> m_offsets;
+
+    }; // class packed_string_array
+
+} // namespace stuff::container
+
+#endif // STUFF_CONTAINER_PACKED_STRING_ARRAY_H
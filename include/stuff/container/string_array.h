@@ -18,6 +18,7 @@
 #ifndef STUFF_CONTAINER_STRING_ARRAY_H
 #define STUFF_CONTAINER_STRING_ARRAY_H
 
+#include <boost/container/small_vector.hpp>
 #include <string>
 #include <string_view>
 #include <vector>
@@ -30,6 +31,14 @@ namespace stuff::container {
     using string_array      = std::vector<std::string>;
     using string_view_array = std::vector<std::string_view>;
 
+    //
+    // Array of string views that stores up to 16 elements inline (i.e., no
+    // heap allocation) and only spills to the heap beyond that. Useful for
+    // the fields of short records.
+    //
+    using small_string_view_array =
+        boost::container::small_vector<std::string_view, 16>;
+
 } // namespace stuff::container
 
 #endif // STUFF_CONTAINER_STRING_ARRAY_H
@@ -0,0 +1,95 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef STUFF_CORE_CPU_H
+#define STUFF_CORE_CPU_H
+
+#include <cstddef>
+
+//
+// Kernels for instruction sets beyond the baseline (e.g., AVX2) are compiled
+// with a target attribute and chosen at run time, so the library runs on any
+// x86-64 CPU. STUFF_AVX2_DISPATCH is defined where that is possible.
+//
+#if defined(__x86_64__) && defined(__GNUC__)
+    #include <immintrin.h>
+    #define STUFF_AVX2_DISPATCH
+    #define STUFF_TARGET_AVX2 __attribute__((target("avx2")))
+    #define STUFF_TARGET_AVX2_POPCNT __attribute__((target("avx2,popcnt")))
+    #define STUFF_TARGET_SSE42 __attribute__((target("sse4.2")))
+#endif
+
+namespace stuff::core {
+
+    //
+    // Helper's for this library. Do not call from outside this library.
+    //
+    namespace detail {
+
+#if defined(STUFF_AVX2_DISPATCH)
+
+        // does the CPU have the instructions of feature (asked once each)?
+        inline bool have_avx2() noexcept
+        {
+            static const bool avx2 = []() noexcept {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("avx2") != 0;
+            }();
+            return avx2;
+        }
+
+        inline bool have_popcnt() noexcept
+        {
+            static const bool popcnt = []() noexcept {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("popcnt") != 0;
+            }();
+            return popcnt;
+        }
+
+        inline bool have_sse42() noexcept
+        {
+            static const bool sse42 = []() noexcept {
+                __builtin_cpu_init();
+                return __builtin_cpu_supports("sse4.2") != 0;
+            }();
+            return sse42;
+        }
+
+        //
+        // Fewer bytes than this are not worth the AVX2 warm up (i.e., of the
+        // upper 128 bits) of a kernel that scans them once.
+        //
+        constexpr std::size_t avx2_min_bytes = 64;
+
+        //
+        // Should a kernel process n bytes (or items; then min_size is in
+        // items too) with AVX2?
+        //
+        inline bool use_avx2(
+            std::size_t n, std::size_t min_size = avx2_min_bytes) noexcept
+        {
+            return n >= min_size && have_avx2();
+        }
+
+#endif
+
+    } // namespace detail
+
+} // namespace stuff::core
+
+#endif // STUFF_CORE_CPU_H
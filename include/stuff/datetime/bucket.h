@@ -0,0 +1,250 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef STUFF_DATETIME_BUCKET_H
+#define STUFF_DATETIME_BUCKET_H
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <stuff/core/exception.h>
+#include <stuff/datetime/conversions.h>
+#include <stuff/datetime/types.h>
+#include <stuff/datetime/zone.h>
+#include <vector>
+
+namespace stuff::datetime {
+
+    //
+    // Floor times to buckets (e.g., bars) of a fixed size counted from an
+    // origin (by default the epoch, so 1s, 1min, 5min, etc. buckets are
+    // those of date::floor), i.e., the start of the bucket of each time is
+    //   origin + floor((times[k] - origin) / size) * size
+    // There is no integer division in AVX2, so the division is a multiply
+    // by a reciprocal (computed once for size) and 4 times at once when the
+    // CPU has AVX2.
+    //
+    // For example:
+    //   floor_times(times.data(), times.size(), 5min, starts.data());
+    //
+    void floor_times(const sys_time* times, std::size_t count, duration size,
+        sys_time* starts, sys_time origin = sys_time {});
+
+    [[nodiscard]] std::vector<sys_time> floor_times(
+        const std::vector<sys_time>& times, duration size,
+        sys_time origin = sys_time {});
+
+    //
+    // Same as floor_times(), but the index of each bucket, i.e.,
+    //   floor((times[k] - origin) / size)
+    //
+    void bucket_indexes(const sys_time* times, std::size_t count,
+        duration size, std::int64_t* indexes, sys_time origin = sys_time {});
+
+    [[nodiscard]] std::vector<std::int64_t> bucket_indexes(
+        const std::vector<sys_time>& times, duration size,
+        sys_time origin = sys_time {});
+
+    // buckets that start at local midnight of a time zone
+    enum class calendar_interval {
+        day,   // every day
+        week,  // every Sunday (see find_sunday())
+        month, // the first day of every month
+    };
+
+    //
+    // Floor times to the local days, weeks or months of zone, i.e., the
+    // start of each bucket is local midnight (or the time of the transition,
+    // if the clocks go forward over midnight), whatever the offset from UTC.
+    // Sorted times are quickest: a time in the same bucket as the time
+    // before it is a comparison instead of a conversion.
+    //
+    void floor_times(const sys_time* times, std::size_t count,
+        calendar_interval interval, const fast_zone& zone, sys_time* starts);
+
+    [[nodiscard]] std::vector<sys_time> floor_times(
+        const std::vector<sys_time>& times, calendar_interval interval,
+        const fast_zone& zone);
+
+    // the open, high, low and close prices and volume of ticks in a bucket
+    struct ohlcv_bar {
+        sys_time    start {};  // of the bucket
+        double      open {};   // the first price
+        double      high {};   // the highest price
+        double      low {};    // the lowest price
+        double      close {};  // the last price
+        double      volume {}; // the sum of the volumes
+        std::size_t ticks {};  // how many
+    };
+
+    //
+    // Resample a stream of ticks (e.g., trades) to OHLCV bars of a fixed
+    // size or a calendar interval (see floor_times()). Ticks come in time
+    // order, a bar is done with when a tick falls in a later bucket, and
+    // there is no bar for a bucket without ticks.
+    //
+    // For example:
+    //   ohlcv_resampler resampler {1min};
+    //   resampler.add(times, prices, volumes, count,
+    //       [&](const ohlcv_bar& bar) { bars.push_back(bar); });
+    //   if (auto bar = resampler.flush()) {
+    //       bars.push_back(*bar);
+    //   }
+    //
+    class ohlcv_resampler {
+    public:
+        explicit ohlcv_resampler(duration size, sys_time origin = sys_time {});
+
+        // zone must outlive the resampler (e.g., locate_fast_zone())
+        ohlcv_resampler(calendar_interval interval, const fast_zone& zone);
+
+        //
+        // Add the tick at t; return the bar it finishes, if any. Throws
+        // datetime_error if t is in a bucket before the current bar.
+        //
+        std::optional<ohlcv_bar> add(sys_time t, double price, double volume)
+        {
+            if (m_bar && t >= m_bar->start && t < m_end) {
+                update(*m_bar, price, volume);
+                return std::nullopt;
+            }
+            sys_time start;
+            floor(&t, 1, &start);
+            return add_to(start, price, volume);
+        }
+
+        //
+        // Add count ticks and call on_bar(const ohlcv_bar&) for each bar
+        // they finish. The times are floored in batches by the kernels above
+        // (i.e., with SIMD for a fixed size). If it throws (e.g., a tick out
+        // of order, flooring a batch of times fails, or on_bar() throws), the
+        // ticks before that one are in the bars passed to on_bar() or the
+        // current bar, and the rest are not added.
+        //
+        template <typename F>
+        void add(const sys_time* times, const double* prices,
+            const double* volumes, std::size_t count, F on_bar)
+        {
+            if (count == 0) {
+                return;
+            }
+
+            // build the bar in a local (i.e., in registers, not memory) and
+            // save it before anything (i.e., on_bar()) can throw
+            std::array<sys_time, batch_size> starts;
+            auto bar = m_bar.value_or(ohlcv_bar {});
+            for (std::size_t i = 0; i < count; i += batch_size) {
+                const auto n = std::min(batch_size, count - i);
+                if (m_bar) {
+                    m_bar = bar;
+                }
+                floor(times + i, n, starts.data());
+
+                std::size_t k = 0;
+                if (!m_bar) {
+                    bar = start_bar(starts[0], prices[0], volumes[0]);
+                    k   = 1;
+                }
+                for (; k < n; ++k) {
+                    const auto price  = prices[i + k];
+                    const auto volume = volumes[i + k];
+                    if (starts[k] == bar.start) {
+                        update(bar, price, volume);
+                        continue;
+                    }
+                    m_bar = bar;
+                    STUFF_EXPECTS(starts[k] > bar.start, datetime_error,
+                        "tick is before the current bar");
+                    const auto done = bar;
+                    bar             = start_bar(starts[k], price, volume);
+                    on_bar(done);
+                }
+            }
+            m_bar = bar;
+        }
+
+        // the bar being built, if any
+        [[nodiscard]] const std::optional<ohlcv_bar>& current() const noexcept
+        {
+            return m_bar;
+        }
+
+        // finish the bar being built, if any (e.g., at the end of the ticks)
+        std::optional<ohlcv_bar> flush() noexcept
+        {
+            auto bar = m_bar;
+            m_bar.reset();
+            return bar;
+        }
+
+    private:
+        static constexpr std::size_t batch_size = 256;
+
+        void floor(const sys_time* times, std::size_t count,
+            sys_time* starts) const;
+
+        // the start of the bucket after the one that starts at start
+        [[nodiscard]] sys_time bucket_end(sys_time start) const;
+
+        static void update(ohlcv_bar& bar, double price, double volume)
+        {
+            bar.high  = std::max(bar.high, price);
+            bar.low   = std::min(bar.low, price);
+            bar.close = price;
+            bar.volume += volume;
+            ++bar.ticks;
+        }
+
+        std::optional<ohlcv_bar> add_to(
+            sys_time start, double price, double volume)
+        {
+            std::optional<ohlcv_bar> done;
+            if (m_bar && start == m_bar->start) {
+                update(*m_bar, price, volume);
+                return done;
+            }
+            if (m_bar) {
+                STUFF_EXPECTS(start > m_bar->start, datetime_error,
+                    "tick is before the current bar");
+                done = m_bar;
+            }
+            start_bar(start, price, volume);
+            return done;
+        }
+
+        // make (and return) the current bar of a tick in a new bucket
+        ohlcv_bar start_bar(sys_time start, double price, double volume)
+        {
+            m_bar = ohlcv_bar {start, price, price, price, price, volume, 1};
+            m_end = bucket_end(start);
+            return *m_bar;
+        }
+
+        duration                 m_size {0}; // 0 for a calendar interval
+        sys_time                 m_origin;
+        sys_time                 m_end; // of the current bar
+        calendar_interval        m_interval {calendar_interval::day};
+        const fast_zone*         m_zone {nullptr};
+        std::optional<ohlcv_bar> m_bar;
+
+    }; // class ohlcv_resampler
+
+} // namespace stuff::datetime
+
+#endif // STUFF_DATETIME_BUCKET_H
@@ -0,0 +1,207 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef STUFF_DATETIME_CALENDAR_H
+#define STUFF_DATETIME_CALENDAR_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <stuff/datetime/types.h>
+#include <vector>
+
+namespace stuff::datetime {
+
+    // a time a market is open: from open up to (but not including) close
+    struct session {
+        sys_time open;
+        sys_time close;
+    };
+
+    //
+    // Helper's for this library. Do not call from outside this library.
+    //
+    namespace detail {
+
+        //
+        // Sorted, disjoint sessions as an array of opens and closes with the
+        // first of them at (or after) the start of every day in a range, so
+        // that finding a time is a table lookup and a step or two (or a
+        // binary search outside the range).
+        //
+        class session_table {
+        public:
+            session_table() = default;
+
+            //
+            // Make the table of sessions (in any order; those that overlap or
+            // touch are merged) indexed from begin up to end.
+            //
+            session_table(
+                sys_time begin, sys_time end, std::vector<session> sessions);
+
+            [[nodiscard]] bool in_range(sys_time t) const noexcept
+            {
+                return t >= m_begin && t < m_end;
+            }
+
+            // the number of opens and closes at or before t (odd when open)
+            [[nodiscard]] std::size_t find(sys_time t) const noexcept;
+
+            [[nodiscard]] bool is_open(sys_time t) const noexcept
+            {
+                return (find(t) & 1) != 0;
+            }
+
+            // the session t is in, if any
+            [[nodiscard]] std::optional<session> session_of(
+                sys_time t) const noexcept;
+
+            // the first open after t, if any
+            [[nodiscard]] std::optional<sys_time> next_open(
+                sys_time t) const noexcept;
+
+            // the time open before t
+            [[nodiscard]] duration open_time(sys_time t) const noexcept;
+
+            //
+            // Call set(i, open) for each of the times, where open is whether
+            // times[i] is in a session. For sorted times (e.g., ticks), this
+            // only steps forward through the sessions.
+            //
+            template <typename F>
+            void classify(
+                const sys_time* times, std::size_t count, F set) const
+            {
+                std::size_t i = 0;
+                for (std::size_t k = 0; k < count; ++k) {
+                    const auto t = times[k];
+                    if (i == 0 || t < m_bells[i - 1]) {
+                        i = find(t);
+                    }
+                    while (i < m_bells.size() && m_bells[i] <= t) {
+                        ++i;
+                    }
+                    set(k, (i & 1) != 0);
+                }
+            }
+
+        private:
+            sys_time                   m_begin;
+            sys_time                   m_end;
+            std::vector<sys_time>      m_bells; // open, close, open, ...
+            std::vector<duration>      m_open;  // time open at each bell
+            std::vector<std::uint32_t> m_days;  // first bell at each day
+
+        }; // class session_table
+
+    } // namespace detail
+
+    // the hours of a session as times from the midnight of a trading day
+    struct trading_hours {
+        duration open;
+        duration close;
+    };
+
+    // a day a venue closes early (e.g., the day after Thanksgiving)
+    struct early_close {
+        local_days day;
+        duration   close; // from midnight
+    };
+
+    //
+    // The rules of a venue (e.g., an exchange): its time zone, the sessions
+    // of its trading days and the days it is closed or closes early. All are
+    // local times of the venue.
+    //
+    // For example, the New York Stock Exchange trades from 9:30 AM to 4:00
+    // PM, Monday through Friday, and the Tokyo Stock Exchange breaks for
+    // lunch:
+    //   venue_rules nyse {"XNYS", "America/New_York", {{9h + 30min, 16h}}};
+    //   venue_rules tse {"XTKS", "Asia/Tokyo",
+    //       {{9h, 11h + 30min}, {12h + 30min, 15h}}};
+    //
+    // A session may start the day before (i.e., a negative open); e.g., for
+    // futures that trade from 5:00 PM to 4:00 PM the next day: {-7h, 16h}.
+    //
+    struct venue_rules {
+        std::string                name;
+        std::string                zone; // see locate_fast_zone()
+        std::vector<trading_hours> sessions;
+        std::vector<date::weekday> weekdays {date::Monday, date::Tuesday,
+            date::Wednesday, date::Thursday, date::Friday};
+        std::vector<local_days>    holidays {};
+        std::vector<early_close>   early_closes {};
+    };
+
+    //
+    // The sessions of a venue for a range of years (in UTC), compiled from
+    // its rules into a table (see detail::session_table) so that queries do
+    // no time zone conversions. Throws datetime_error for a time outside the
+    // range.
+    //
+    // For example:
+    //   const trading_calendar nyse {rules, date::year {2000},
+    //       date::year {2030}};
+    //   if (nyse.is_open(t)) ...
+    //   auto trading_time = nyse.duration_between(entry, exit);
+    //
+    class trading_calendar {
+    public:
+        trading_calendar(
+            const venue_rules& rules, date::year first, date::year last);
+
+        [[nodiscard]] inline const std::string& name() const noexcept
+        {
+            return m_name;
+        }
+
+        [[nodiscard]] bool is_open(sys_time t) const;
+
+        // the session t is in, if any
+        [[nodiscard]] std::optional<session> session_of(sys_time t) const;
+
+        // the first open after t (throws datetime_error if there is none)
+        [[nodiscard]] sys_time next_open(sys_time t) const;
+
+        // the time open from (inclusive) to (exclusive); negative if to is
+        // before from
+        [[nodiscard]] duration duration_between(
+            sys_time from, sys_time to) const;
+
+        //
+        // Set open[i] to whether times[i] is in a session, for count times.
+        // Sorted times (e.g., ticks) are the fastest.
+        //
+        void classify(
+            const sys_time* times, std::size_t count, bool* open) const;
+
+        [[nodiscard]] std::vector<bool> classify(
+            const std::vector<sys_time>& times) const;
+
+    private:
+        void expects_in_range(sys_time t) const;
+
+        std::string           m_name;
+        detail::session_table m_table;
+
+    }; // class trading_calendar
+
+} // namespace stuff::datetime
+
+#endif // STUFF_DATETIME_CALENDAR_H
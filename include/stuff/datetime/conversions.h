@@ -18,9 +18,16 @@
 #ifndef STUFF_DATETIME_CONVERSIONS_H
 #define STUFF_DATETIME_CONVERSIONS_H
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
 #include <string_view>
 #include <stuff/core/exception.h>
 #include <stuff/datetime/types.h>
+#include <stuff/string/convert.h>
+#include <stuff/string/record.h>
+#include <vector>
 
 namespace stuff::datetime {
 
@@ -53,11 +60,81 @@ namespace stuff::datetime {
     [[nodiscard]] sys_time   to_sys_time(std::string_view view);
     [[nodiscard]] local_time to_local_time(std::string_view view);
 
+    //
+    // Same as above, but never throw: the result holds the time or an error
+    // code (std::errc::invalid_argument). Use these when bad strings are
+    // expected (e.g., junk rows in a file), since nothing is thrown or
+    // allocated.
+    //
+    [[nodiscard]] string::conversion_result<sys_time> try_to_sys_time(
+        std::string_view view) noexcept;
+    [[nodiscard]] string::conversion_result<local_time> try_to_local_time(
+        std::string_view view) noexcept;
+
+    //
+    // Convert many strings to times at once (e.g., a column of a file). The
+    // usual layout (to the nanosecond) is validated and converted with AVX2
+    // when the CPU supports it; any other string is converted as by
+    // to_sys_time(). Throws datetime_error for the first invalid string (the
+    // times before it are converted).
+    //
+    // Parameters:
+    //   views    Strings to convert.
+    //   count    Number of strings.
+    //   times    Where to put the times (at least count of them).
+    //   threads  Number of threads to use (0 is one per core). Threads only
+    //            pay for very large columns (e.g., a million strings).
+    //
+    void to_sys_times(const std::string_view* views, std::size_t count,
+        sys_time* times, unsigned threads = 1);
+
+    [[nodiscard]] std::vector<sys_time> to_sys_times(
+        const std::vector<std::string_view>& views, unsigned threads = 1);
+
+    //
+    // Same as above, but for strings of the same size that are stride bytes
+    // apart in a buffer (e.g., a column of fixed-width records): string i is
+    // [first + i * stride, first + i * stride + size).
+    //
+    void to_sys_times(const char* first, std::size_t size, std::size_t stride,
+        std::size_t count, sys_time* times, unsigned threads = 1);
+
     // Convenience conversions:
     // to sys_time from local string and zone
     [[nodiscard]] sys_time to_sys_time(
         std::string_view local_view, time_zone local_tz);
 
+    //
+    // The number of characters format_to() writes for a time (e.g.,
+    // "2020-03-21T09:34:51.123456789Z" or "2020-03-21T09:34:51.123456789").
+    //
+    inline constexpr std::size_t sys_time_size   = 30;
+    inline constexpr std::size_t local_time_size = 29;
+
+    //
+    // Fast, allocation-free version of to_string() (below): write exactly
+    // sys_time_size (or local_time_size) characters to out; no terminating
+    // null is written.
+    //
+    // Parameters:
+    //   out  Where to write the characters.
+    //   t    Time to convert.
+    //
+    // Returns:
+    //   Pointer one past the last character written.
+    //
+    char* format_to(char* out, sys_time t) noexcept;
+    char* format_to(char* out, local_time t) noexcept;
+
+    //
+    // Same as above, but for many times (e.g., a column of a file): count
+    // times are written back to back, sys_time_size characters apart (see
+    // the strided to_sys_times()). Times of the same day as the one before
+    // reuse its date, so sorted times are the fastest.
+    //
+    char* format_to(
+        char* out, const sys_time* times, std::size_t count) noexcept;
+
     // Quickly convert the given time to a string with nanosecond resolution.
     // The output will be of the form:
     //  2020-03-21T09:34:51.123456789Z (for sys_time)
@@ -67,6 +144,68 @@ namespace stuff::datetime {
     [[nodiscard]] std::string to_string(local_time t);
     [[nodiscard]] std::string to_string(zoned_time t);
 
+    //
+    // Convert sorted times (e.g., tick data) to and from strings faster than
+    // the functions above: the date of the last day parsed and of the last
+    // day formatted is kept, so times of the same day only convert the time
+    // of day. Times in any order give the same results, just more slowly.
+    //
+    // Not thread-safe: use one per thread (e.g., one per file being read).
+    //
+    // For example:
+    //   time_converter converter;
+    //   for (auto line : lines) {
+    //       auto t = converter.to_sys_time(line.substr(0, sys_time_size));
+    //       ...
+    //   }
+    //
+    class time_converter {
+    public:
+        // See the functions of the same name above.
+        [[nodiscard]] sys_time to_sys_time(std::string_view view);
+        [[nodiscard]] string::conversion_result<sys_time> try_to_sys_time(
+            std::string_view view) noexcept;
+
+        char* format_to(char* out, sys_time t) noexcept;
+        [[nodiscard]] std::string to_string(sys_time t);
+
+    private:
+        using date_string = std::array<char, 10>; // "YYYY-MM-DD"
+
+        // the last day parsed and formatted (the epoch until then)
+        date_string  m_parse_date {'1', '9', '7', '0', '-', '0', '1', '-', '0',
+            '1'};
+        std::int64_t m_parse_days {0};
+        date_string  m_format_date {m_parse_date};
+        std::int64_t m_format_days {0};
+
+    }; // class time_converter
+
 } // namespace stuff::datetime
 
+namespace stuff::string {
+
+    //
+    // Allow times to be fields of string::parse_record().
+    //
+    template <>
+    struct field_converter<datetime::sys_time> {
+        [[nodiscard]] static inline conversion_result<datetime::sys_time>
+            convert(std::string_view view) noexcept
+        {
+            return datetime::try_to_sys_time(view);
+        }
+    };
+
+    template <>
+    struct field_converter<datetime::local_time> {
+        [[nodiscard]] static inline conversion_result<datetime::local_time>
+            convert(std::string_view view) noexcept
+        {
+            return datetime::try_to_local_time(view);
+        }
+    };
+
+} // namespace stuff::string
+
 #endif // STUFF_DATETIME_CONVERSIONS_H
@@ -18,7 +18,12 @@
 #ifndef STUFF_DATETIME_FINANCIAL_H
 #define STUFF_DATETIME_FINANCIAL_H
 
+#include <istream>
+#include <optional>
+#include <string>
+#include <stuff/datetime/calendar.h>
 #include <stuff/datetime/types.h>
+#include <vector>
 
 namespace stuff::datetime {
 
@@ -31,6 +36,69 @@ namespace stuff::datetime {
     };
     [[nodiscard]] forex_bells get_forex_bells(sys_time t) noexcept;
 
+    // a time the foreign exchange is closed (e.g., a holiday)
+    struct forex_closure {
+        sys_time from;
+        sys_time to;
+    };
+
+    //
+    // Read forex closures, one a line, as New York local times:
+    //   2020-12-25                               the trading day (i.e., from
+    //                                            5:00 PM the day before)
+    //   2020-12-24T13:00:00 2020-12-24T17:00:00  from and to
+    // Blank lines and lines starting with # are skipped. Throws
+    // datetime_error for a bad line or a file that cannot be read.
+    //
+    [[nodiscard]] std::vector<forex_closure> read_forex_closures(
+        std::istream& in);
+    [[nodiscard]] std::vector<forex_closure> read_forex_closures(
+        const std::string& filename);
+
+    //
+    // The forex sessions (see get_forex_bells()) of a range of years less
+    // the closures, precomputed as a sorted array of opens and closes with
+    // an index of the first at each day (see detail::session_table).
+    // Checking a time is then a table lookup (and a step or two) instead of
+    // time zone conversions.
+    //
+    // Times outside the range are checked with get_forex_bells() (i.e.,
+    // without closures).
+    //
+    // For example:
+    //   const forex_calendar calendar {date::year {2020}, date::year {2030},
+    //       read_forex_closures("holidays.txt")};
+    //   if (calendar.is_open(tick.time)) ...
+    //
+    class forex_calendar {
+    public:
+        forex_calendar(date::year first, date::year last,
+            std::vector<forex_closure> closures = {});
+
+        [[nodiscard]] bool is_open(sys_time t) const noexcept;
+
+        //
+        // The session (i.e., from an open to the next close, which may be a
+        // closure) t is in, if any.
+        //
+        [[nodiscard]] std::optional<forex_bells> session_of(
+            sys_time t) const noexcept;
+
+        //
+        // Set open[i] to whether times[i] is in a session, for count times.
+        // Sorted times (e.g., ticks) are the fastest.
+        //
+        void classify(const sys_time* times, std::size_t count,
+            bool* open) const noexcept;
+
+        [[nodiscard]] std::vector<bool> classify(
+            const std::vector<sys_time>& times) const;
+
+    private:
+        detail::session_table m_table;
+
+    }; // class forex_calendar
+
 } // namespace stuff::datetime
 
 #endif // STUFF_DATETIME_FINANCIAL_H
@@ -0,0 +1,189 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#ifndef STUFF_DATETIME_ZONE_H
+#define STUFF_DATETIME_ZONE_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <stuff/datetime/conversions.h>
+#include <stuff/datetime/types.h>
+#include <utility>
+#include <vector>
+
+namespace stuff::datetime {
+
+    //
+    // Helper's for this library. Do not call from outside this library.
+    //
+    namespace detail {
+
+        // a time zone compiled into the library and its TZif file
+        struct embedded_zone {
+            const char*          name;
+            const unsigned char* data;
+            std::size_t          size;
+        };
+
+        //
+        // The time zones compiled into the library, sorted by name (none
+        // unless it is built with STUFF_EMBED_TZDB).
+        //
+        std::pair<const embedded_zone*, std::size_t> embedded_zones() noexcept;
+
+    } // namespace detail
+
+    //
+    // What to do with a local time that happens twice (i.e., when the clocks
+    // go back) or never (when the clocks go forward). Like date::choose,
+    // earliest and latest both give the time of the transition for a local
+    // time that never happens.
+    //
+    enum class local_policy {
+        earliest, // the earlier of the two times
+        latest,   // the later of the two times
+        error     // throw datetime_error
+    };
+
+    //
+    // A time zone's offsets from UTC, precomputed for a range of years as a
+    // sorted array of transitions (i.e., the times the offset changes) and a
+    // table with the transition in effect at the start of every day. Local
+    // and sys time conversions are then a table lookup instead of a search
+    // of the time zone database (as date::make_zoned() does on every call).
+    //
+    // Times outside the range are converted by the time zone itself (the
+    // same results, just slower).
+    //
+    // A fast_zone can also be made from a TZif file (RFC 8536; e.g., as in
+    // /usr/share/zoneinfo) without loading the time zone database at all;
+    // see locate_fast_zone().
+    //
+    // For example:
+    //   static const fast_zone nyc {nyc_tz(), date::year {2000},
+    //       date::year {2030}};
+    //   auto local = nyc.to_local(t);
+    //
+    class fast_zone {
+    public:
+        //
+        // Precompute tz for the years first through last.
+        //
+        fast_zone(time_zone tz, date::year first, date::year last);
+
+        //
+        // Precompute the time zone name from its TZif file for the years
+        // first through last. The rule at the end of the file gives the
+        // transitions after the last one in it. Times outside the range are
+        // converted by date::locate_zone(name).
+        //
+        fast_zone(std::string name, std::string_view tzif, date::year first,
+            date::year last);
+
+        [[nodiscard]] inline const std::string& name() const noexcept
+        {
+            return m_name;
+        }
+
+        // the time zone (located now if made from a TZif file)
+        [[nodiscard]] time_zone zone() const;
+
+        // offset from UTC at t (e.g., -5 hours for New York in winter)
+        [[nodiscard]] std::chrono::seconds offset(sys_time t) const;
+
+        [[nodiscard]] local_time to_local(sys_time t) const;
+
+        //
+        // Convert a local time to sys time; policy decides the local times
+        // that happen twice or never.
+        //
+        [[nodiscard]] sys_time to_sys(
+            local_time t, local_policy policy = local_policy::error) const;
+
+        //
+        // Same as above, but return nothing for a local time that happens
+        // twice or never.
+        //
+        [[nodiscard]] std::optional<sys_time> try_to_sys(local_time t) const;
+
+    private:
+        struct transition {
+            sys_time             begin;  // when this offset starts
+            std::chrono::seconds offset; // from UTC
+
+            // local times in [local_begin, local_end) happen twice or never
+            local_time local_begin;
+            local_time local_end;
+        };
+
+        // the sys times of a local time (the same two if it is unique)
+        struct local_result {
+            enum { unique, nonexistent, ambiguous } kind;
+            sys_time earliest;
+            sys_time latest;
+        };
+
+        void set_range(date::year first, date::year last);
+
+        // add the transition to offset at begin (if the offset changes)
+        void add(sys_time begin, std::chrono::seconds offset);
+
+        // make the tables of the transition at each day
+        void index();
+
+        [[nodiscard]] bool in_range(sys_time t) const noexcept;
+        [[nodiscard]] bool in_range(local_time t) const noexcept;
+
+        // the transition in effect at t
+        [[nodiscard]] std::size_t find(sys_time t) const noexcept;
+
+        // the last transition with local_begin <= t
+        [[nodiscard]] std::size_t find(local_time t) const noexcept;
+
+        [[nodiscard]] local_result resolve(local_time t) const;
+
+        std::string                m_name;
+        time_zone                  m_tz {nullptr};
+        sys_time                   m_begin; // the day before the first year
+        sys_time                   m_end;   // the day after the last year
+        std::vector<transition>    m_transitions;
+        std::vector<std::uint32_t> m_sys_days;   // transition at each day
+        std::vector<std::uint32_t> m_local_days; // (UTC and local midnight)
+
+    }; // class fast_zone
+
+    //
+    // The fast_zone of the time zone name for 1970 through 2069, made the
+    // first time it is asked for: from the time zone database compiled into
+    // the library if there is one (see STUFF_EMBED_TZDB) and it has name,
+    // otherwise from date::locate_zone(). Throws datetime_error for an
+    // unknown name.
+    //
+    [[nodiscard]] const fast_zone& locate_fast_zone(std::string_view name);
+
+    //
+    // Quick access to the fast_zone of New York (US East; see nyc_tz() and
+    // locate_fast_zone()).
+    //
+    [[nodiscard]] const fast_zone& nyc_fast_zone();
+
+} // namespace stuff::datetime
+
+#endif // STUFF_DATETIME_ZONE_H
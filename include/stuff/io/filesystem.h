@@ -23,12 +23,14 @@
 #include <boost/iostreams/filter/bzip2.hpp>
 #include <boost/iostreams/filter/gzip.hpp>
 #include <boost/iostreams/filtering_stream.hpp>
+#include <cstring>
 #include <ios>
 #include <iterator>
 #include <string>
 #include <string_view>
 #include <stuff/container/byte_array.h>
 #include <stuff/core/exception.h>
+#include <stuff/string/match.h>
 #include <utility>
 
 // Use Boost instead of std::filesystem for now.
@@ -135,6 +137,34 @@ namespace stuff::io {
             return result;
         }
 
+        // size of the blocks read by read_as_lines() with a multi_matcher
+        inline constexpr std::size_t read_block_size = 1 << 20;
+
+        //
+        // Pass each line of view with a match to f(); lines are only found
+        // around a match.
+        //
+        template <typename Function>
+        inline void for_each_matching_line(std::string_view view,
+            const string::multi_matcher& matcher, Function& f)
+        {
+            while (!view.empty()) {
+                auto match = matcher.find(view);
+                if (!match) {
+                    return;
+                }
+
+                auto begin = view.rfind('\n', match->position);
+                begin      = begin == std::string_view::npos ? 0 : begin + 1;
+                auto end   = view.find('\n', match->position);
+                f(view.substr(begin, end - begin));
+                if (end == std::string_view::npos) {
+                    return;
+                }
+                view.remove_prefix(end + 1);
+            }
+        }
+
     } // namespace detail
 
 
@@ -163,6 +193,42 @@ namespace stuff::io {
         }
     }
 
+    // Read only the lines of a text file that contain any of the patterns in
+    // matcher (e.g., a few hundred symbols). f() must accept each line as a
+    // std::string_view, which is only valid during the call.
+    // The file is read in large blocks that are searched as is, so lines
+    // without a match are never split or copied. Note: The patterns can not
+    // contain a new line.
+    template <typename Function>
+    inline void read_as_lines(const fs::path& filename, compression_type ct,
+        const string::multi_matcher& matcher, Function f)
+    {
+        detail::istream_wrapper file {filename, std::ifstream::in};
+        file.noskipws();
+        file.enable_compression(ct);
+        file.connect();
+
+        std::string buffer(detail::read_block_size, '\0');
+        std::size_t kept = 0; // the unfinished last line of the last block
+        while (file) {
+            file.stream().read(buffer.data() + kept, buffer.size() - kept);
+            const auto size =
+                kept + static_cast<std::size_t>(file.stream().gcount());
+
+            // only search whole lines, unless this is the end of the file
+            std::string_view block {buffer.data(), size};
+            const auto       end = file ? block.rfind('\n') + 1 : size;
+            detail::for_each_matching_line(block.substr(0, end), matcher, f);
+
+            kept = size - end;
+            std::memmove(buffer.data(), buffer.data() + end, kept);
+            if (kept == buffer.size()) {
+                // a line longer than the buffer
+                buffer.resize(2 * buffer.size());
+            }
+        }
+    }
+
     // Apply f() to each directory in dir.
     // f() must be a unary function taking a directory_entry (or path).
     template <typename Function>
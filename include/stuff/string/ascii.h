@@ -0,0 +1,78 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <string_view>
+
+#ifndef STUFF_STRING_ASCII_H
+    #define STUFF_STRING_ASCII_H
+
+namespace stuff::string {
+
+    //
+    // Fast trimming, case folding, and character classification of ASCII
+    // strings.
+    //
+    // These functions are small per call, but run on every field of every
+    // row, so 32 characters are processed at once when the CPU supports AVX2
+    // (checked once at runtime), otherwise 16 (SSE2) or one at a time.
+    //
+    // Unlike <cctype>, the locale is ignored and bytes outside of ASCII are
+    // never whitespace, letters, or digits (and are never changed).
+    //
+
+    //
+    // Return view without leading/trailing/both whitespace (i.e., ' ', '\t',
+    // '\n', '\v', '\f', and '\r'). Note: Non-owning.
+    //
+    [[nodiscard]] std::string_view ltrim(std::string_view view) noexcept;
+    [[nodiscard]] std::string_view rtrim(std::string_view view) noexcept;
+    [[nodiscard]] std::string_view trim(std::string_view view) noexcept;
+
+    //
+    // Convert 'a'-'z' to 'A'-'Z' (or the reverse) in place.
+    //
+    void to_upper_ascii(char* first, char* last) noexcept;
+    void to_lower_ascii(char* first, char* last) noexcept;
+
+    inline void to_upper_ascii(std::string& str) noexcept
+    {
+        to_upper_ascii(str.data(), str.data() + str.size());
+    }
+    inline void to_lower_ascii(std::string& str) noexcept
+    {
+        to_lower_ascii(str.data(), str.data() + str.size());
+    }
+
+    enum class char_class {
+        digit, // '0'-'9'
+        alpha, // 'A'-'Z' and 'a'-'z'
+        alnum, // digit or alpha
+        space  // same as trim()
+    };
+
+    //
+    // Return true if every character of view is in the class (e.g., to check
+    // that a field is all digits before converting it). An empty view is
+    // trivially true.
+    //
+    [[nodiscard]] bool all_of_class(
+        std::string_view view, char_class cls) noexcept;
+
+} // namespace stuff::string
+
+#endif // STUFF_STRING_ASCII_H
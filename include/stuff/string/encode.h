@@ -0,0 +1,66 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <string>
+#include <string_view>
+#include <stuff/container/byte_array.h>
+#include <stuff/core/exception.h>
+
+#ifndef STUFF_STRING_ENCODE_H
+    #define STUFF_STRING_ENCODE_H
+
+namespace stuff::string {
+
+    STUFF_DEFINE_EXCEPTION(encoding_error, core::generic_error);
+
+    //
+    // Fast conversion of binary data (e.g., a byte_array) to and from text.
+    //
+    // Large inputs are converted 32 bytes at a time when the CPU supports
+    // AVX2 (checked once at runtime), otherwise one at a time.
+    //
+
+    //
+    // Convert bytes to lowercase hexadecimal (two characters per byte) and
+    // back. from_hex() accepts upper or lowercase and throws encoding_error
+    // if text is not hexadecimal or has an odd length.
+    //
+    [[nodiscard]] std::string           to_hex(std::string_view bytes);
+    [[nodiscard]] container::byte_array from_hex(std::string_view text);
+
+    [[nodiscard]] inline std::string to_hex(const container::byte_array& bytes)
+    {
+        return to_hex(std::string_view {bytes.data(), bytes.size()});
+    }
+
+    //
+    // Convert bytes to base64 (RFC 4648 with '=' padding) and back.
+    // from_base64() accepts text with or without padding and throws
+    // encoding_error for anything else (including whitespace).
+    //
+    [[nodiscard]] std::string           to_base64(std::string_view bytes);
+    [[nodiscard]] container::byte_array from_base64(std::string_view text);
+
+    [[nodiscard]] inline std::string to_base64(
+        const container::byte_array& bytes)
+    {
+        return to_base64(std::string_view {bytes.data(), bytes.size()});
+    }
+
+} // namespace stuff::string
+
+#endif // STUFF_STRING_ENCODE_H
@@ -0,0 +1,274 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#ifndef STUFF_STRING_FORMAT_H
+    #define STUFF_STRING_FORMAT_H
+
+namespace stuff::string {
+
+    //
+    // The maximum number of characters format_number() will write for a
+    // value of type T (e.g., "-9223372036854775808" or
+    // "-2.2250738585072014e-308").
+    //
+    template <typename T>
+    inline constexpr std::size_t max_number_size =
+        std::is_integral_v<T> ? std::numeric_limits<T>::digits10 + 2
+                              : (std::is_same_v<T, float> ? 15 : 24);
+
+    //
+    // Helper's for this library. Do not call from outside this library.
+    //
+    namespace detail {
+
+        // "00" through "99": two digits can be written with one copy
+        inline constexpr char digit_pairs[] {
+            "0001020304050607080910111213141516171819"
+            "2021222324252627282930313233343536373839"
+            "4041424344454647484950515253545556575859"
+            "6061626364656667686970717273747576777879"
+            "8081828384858687888990919293949596979899"};
+
+        [[nodiscard]] inline int count_digits(std::uint64_t n) noexcept
+        {
+            int digits = 1;
+            while (true) {
+                if (n < 10) {
+                    return digits;
+                }
+                if (n < 100) {
+                    return digits + 1;
+                }
+                if (n < 1000) {
+                    return digits + 2;
+                }
+                if (n < 10000) {
+                    return digits + 3;
+                }
+                n /= 10000;
+                digits += 4;
+            }
+        }
+
+        //
+        // Write the digits of n so that the last digit is just before end;
+        // return the start of the digits.
+        //
+        inline char* write_digits_backward(char* end, std::uint64_t n) noexcept
+        {
+            while (n >= 100) {
+                end -= 2;
+                std::memcpy(end, &digit_pairs[(n % 100) * 2], 2);
+                n /= 100;
+            }
+            if (n >= 10) {
+                end -= 2;
+                std::memcpy(end, &digit_pairs[n * 2], 2);
+            }
+            else {
+                *--end = static_cast<char>('0' + n);
+            }
+            return end;
+        }
+
+        inline char* write_unsigned(char* out, std::uint64_t n) noexcept
+        {
+            char* end = out + count_digits(n);
+            write_digits_backward(end, n);
+            return end;
+        }
+
+    } // namespace detail
+
+    //
+    // Fast, allocation-free conversion of a number to a string.
+    //
+    // The characters are written to out, which must have room for at least
+    // max_number_size<T> characters; no terminating null is written. Integers
+    // are written two digits at a time. Floating-point numbers are written in
+    // the shortest form that converts back to the same value (via
+    // std::to_chars, which uses Ryu).
+    //
+    // Parameters:
+    //   out    Where to write the characters.
+    //   value  Number to convert.
+    //
+    // Returns:
+    //   Pointer one past the last character written.
+    //
+    template <typename T>
+    inline char* format_number(char* out, T value) noexcept
+    {
+        static_assert(std::is_integral_v<T> && !std::is_same_v<T, bool>,
+            "T must be an integer, float, or double");
+
+        if constexpr (std::is_signed_v<T>) {
+            // negate in unsigned arithmetic so that min() does not overflow
+            auto magnitude = static_cast<std::uint64_t>(value);
+            if (value < 0) {
+                *out++    = '-';
+                magnitude = 0 - magnitude;
+            }
+            return detail::write_unsigned(out, magnitude);
+        }
+        else {
+            return detail::write_unsigned(out, value);
+        }
+    }
+
+    char* format_number(char* out, float value) noexcept;
+    char* format_number(char* out, double value) noexcept;
+
+    //
+    // Convert a number to a string with a fixed number of decimal places
+    // (e.g., prices); the result is correctly rounded. The characters are
+    // written to [first, last); no terminating null is written.
+    //
+    // Parameters:
+    //   first      Where to write the characters.
+    //   last       One past the end of the available space.
+    //   value      Number to convert.
+    //   precision  Number of digits after the decimal point.
+    //
+    // Returns:
+    //   Pointer one past the last character written or nullptr if the result
+    //   does not fit.
+    //
+    char* format_fixed(
+        char* first, char* last, double value, int precision) noexcept;
+
+    //
+    // Growable buffer of characters for building output (e.g., a line of a
+    // CSV file) without allocating for every value. Reuse one buffer for
+    // many lines: clear() keeps the memory.
+    //
+    class output_buffer {
+    public:
+        explicit output_buffer(std::size_t capacity = 256);
+
+        //
+        // A moved-from buffer is empty with no capacity; appending to it
+        // allocates again.
+        //
+        inline output_buffer(output_buffer&& other) noexcept
+        : m_data {std::move(other.m_data)},
+          m_size {std::exchange(other.m_size, 0)},
+          m_capacity {std::exchange(other.m_capacity, 0)}
+        {
+        }
+
+        inline output_buffer& operator=(output_buffer&& other) noexcept
+        {
+            m_data     = std::move(other.m_data);
+            m_size     = std::exchange(other.m_size, 0);
+            m_capacity = std::exchange(other.m_capacity, 0);
+            return *this;
+        }
+
+        //
+        // Append a string, a character, or a number (see format_number() and
+        // format_fixed()).
+        //
+        inline output_buffer& append(std::string_view view)
+        {
+            std::memcpy(reserve(view.size()), view.data(), view.size());
+            m_size += view.size();
+            return *this;
+        }
+
+        inline output_buffer& append(char c)
+        {
+            *reserve(1) = c;
+            ++m_size;
+            return *this;
+        }
+
+        template <typename T>
+        inline output_buffer& append_number(T value)
+        {
+            char* out = reserve(max_number_size<T>);
+            char* end = format_number(out, value);
+            m_size    = static_cast<std::size_t>(end - m_data.get());
+            return *this;
+        }
+
+        output_buffer& append_fixed(double value, int precision);
+
+        //
+        // Remove all characters, but keep the memory.
+        //
+        inline void clear() noexcept { m_size = 0; }
+
+        [[nodiscard]] inline const char* data() const noexcept
+        {
+            return m_data.get();
+        }
+        [[nodiscard]] inline std::size_t size() const noexcept
+        {
+            return m_size;
+        }
+        [[nodiscard]] inline std::size_t capacity() const noexcept
+        {
+            return m_capacity;
+        }
+        [[nodiscard]] inline bool empty() const noexcept
+        {
+            return m_size == 0;
+        }
+        [[nodiscard]] inline std::string_view view() const noexcept
+        {
+            return std::string_view {m_data.get(), m_size};
+        }
+        [[nodiscard]] inline std::string str() const
+        {
+            return std::string {m_data.get(), m_size};
+        }
+
+    private:
+        //
+        // Ensure there is room for n more characters; return the end of the
+        // current content.
+        //
+        inline char* reserve(std::size_t n)
+        {
+            if (m_size + n > m_capacity) {
+                grow(m_size + n);
+            }
+            return m_data.get() + m_size;
+        }
+
+        void grow(std::size_t required);
+
+        std::unique_ptr<char[]> m_data;
+        std::size_t             m_size;
+        std::size_t             m_capacity;
+
+    }; // class output_buffer
+
+} // namespace stuff::string
+
+#endif // STUFF_STRING_FORMAT_H
@@ -0,0 +1,62 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <cstdint>
+#include <string_view>
+#include <stuff/container/byte_array.h>
+
+#ifndef STUFF_STRING_HASH_H
+    #define STUFF_STRING_HASH_H
+
+namespace stuff::string {
+
+    //
+    // Fast, non-cryptographic 64-bit hash of a string or binary data (e.g., to
+    // key a cache or find duplicate files). The design follows xxHash3 (i.e.,
+    // 64 bytes at a time into eight 64-bit accumulators), but the values are
+    // not the same as xxHash3's. The values are the same on every CPU, but
+    // long inputs are hashed 32 bytes at a time when it supports AVX2.
+    //
+    // Do not use this where an attacker chooses the input (e.g., to detect
+    // tampering); use a cryptographic hash instead.
+    //
+    [[nodiscard]] std::uint64_t hash64(
+        std::string_view view, std::uint64_t seed = 0) noexcept;
+
+    [[nodiscard]] inline std::uint64_t hash64(
+        const container::byte_array& bytes, std::uint64_t seed = 0) noexcept
+    {
+        return hash64(std::string_view {bytes.data(), bytes.size()}, seed);
+    }
+
+    //
+    // CRC-32C (Castagnoli) checksum, using the CRC32 instruction of SSE 4.2
+    // when the CPU supports it. Pass a previous result as crc to continue a
+    // checksum across several pieces of data.
+    //
+    [[nodiscard]] std::uint32_t crc32c(
+        std::string_view view, std::uint32_t crc = 0) noexcept;
+
+    [[nodiscard]] inline std::uint32_t crc32c(
+        const container::byte_array& bytes, std::uint32_t crc = 0) noexcept
+    {
+        return crc32c(std::string_view {bytes.data(), bytes.size()}, crc);
+    }
+
+} // namespace stuff::string
+
+#endif // STUFF_STRING_HASH_H
@@ -0,0 +1,184 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <shared_mutex>
+#include <string_view>
+#include <stuff/core/exception.h>
+#include <unordered_map>
+#include <vector>
+
+#ifndef STUFF_STRING_INTERN_H
+    #define STUFF_STRING_INTERN_H
+
+namespace stuff::string {
+
+    STUFF_DEFINE_EXCEPTION(symbol_table_error, core::generic_error);
+
+    //
+    // A small integer that identifies an interned string.
+    //
+    using symbol_id = std::uint32_t;
+
+    //
+    // Helper's for this library. Do not call from outside this library.
+    //
+    namespace detail {
+
+        //
+        // Storage for many small strings: characters are copied into large
+        // blocks that never move, so views into them remain valid for the
+        // lifetime of the arena.
+        //
+        class char_arena {
+        public:
+            explicit char_arena(std::size_t block_size = 64 * 1024);
+
+            //
+            // Copy view into the arena and return the (stable) copy.
+            //
+            [[nodiscard]] std::string_view store(std::string_view view);
+
+            //
+            // Total number of bytes allocated for storage.
+            //
+            [[nodiscard]] inline std::size_t capacity() const noexcept
+            {
+                return m_capacity;
+            }
+
+        private:
+            std::vector<std::unique_ptr<char[]>> m_blocks;
+            std::size_t                          m_block_size;
+            std::size_t                          m_used;
+            std::size_t                          m_capacity;
+
+        }; // class char_arena
+
+    } // namespace detail
+
+    //
+    // String interning: map strings that repeat often (e.g., ticker symbols,
+    // venues, account IDs, and other categorical data) to a 32-bit symbol_id.
+    //
+    // Each distinct string is stored once, in an arena, and the ID of a
+    // string never changes, so storing the ID (4 bytes) rather than a string
+    // saves a lot of memory and makes comparisons trivial. IDs are assigned
+    // in order (0, 1, 2, ...), which makes them useful as indexes.
+    //
+    // Lookup takes a std::string_view and does not allocate. This class is
+    // not thread-safe; see concurrent_symbol_table below.
+    //
+    // For example:
+    //   symbol_table symbols;
+    //   auto id = symbols.intern("EUR/USD");
+    //   assert(symbols.view(id) == "EUR/USD");
+    //
+    class symbol_table {
+    public:
+        symbol_table() = default;
+
+        // views into the arena must not be copied
+        symbol_table(const symbol_table&) = delete;
+        symbol_table& operator=(const symbol_table&) = delete;
+        symbol_table(symbol_table&&)                 = default;
+        symbol_table& operator=(symbol_table&&) = default;
+
+        //
+        // Return the ID of view, adding it to the table if needed.
+        //
+        symbol_id intern(std::string_view view);
+
+        //
+        // Return the ID of view if it has been interned.
+        //
+        [[nodiscard]] std::optional<symbol_id> find(
+            std::string_view view) const noexcept;
+
+        //
+        // Return the string for the given ID. The view is valid for the
+        // lifetime of the table. The ID must have been returned by this table.
+        //
+        [[nodiscard]] inline std::string_view view(symbol_id id) const noexcept
+        {
+            return m_views[id];
+        }
+
+        //
+        // Number of interned strings.
+        //
+        [[nodiscard]] inline std::size_t size() const noexcept
+        {
+            return m_views.size();
+        }
+
+    private:
+        detail::char_arena                              m_arena;
+        std::vector<std::string_view>                   m_views;
+        std::unordered_map<std::string_view, symbol_id> m_ids;
+
+    }; // class symbol_table
+
+    //
+    // A thread-safe symbol_table.
+    //
+    // Strings are spread over 2^shard_bits shards by hash; each shard is a
+    // symbol_table with its own lock, so threads interning different strings
+    // rarely wait for each other. Lookups of strings already interned only
+    // take a shared lock. The shard is encoded in the low bits of each ID, so
+    // IDs are unique and stable, but not consecutive.
+    //
+    class concurrent_symbol_table {
+    public:
+        explicit concurrent_symbol_table(unsigned shard_bits = 4);
+
+        symbol_id intern(std::string_view view);
+
+        [[nodiscard]] std::optional<symbol_id> find(
+            std::string_view view) const;
+
+        [[nodiscard]] std::string_view view(symbol_id id) const;
+
+        [[nodiscard]] std::size_t size() const;
+
+    private:
+        struct shard {
+            mutable std::shared_mutex mutex;
+            symbol_table              table;
+        };
+
+        // 2^shard_bits (checked before anything is made of it)
+        [[nodiscard]] static std::size_t shard_count(unsigned shard_bits);
+
+        [[nodiscard]] inline shard& shard_of(std::string_view view) const
+        {
+            auto hash = std::hash<std::string_view> {}(view);
+            return m_shards[hash & m_mask];
+        }
+
+        unsigned                 m_shard_bits;
+        std::size_t              m_mask;
+        std::unique_ptr<shard[]> m_shards;
+
+    }; // class concurrent_symbol_table
+
+} // namespace stuff::string
+
+#endif // STUFF_STRING_INTERN_H
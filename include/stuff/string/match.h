@@ -0,0 +1,118 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <initializer_list>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <stuff/core/exception.h>
+#include <vector>
+
+#ifndef STUFF_STRING_MATCH_H
+    #define STUFF_STRING_MATCH_H
+
+namespace stuff::string {
+
+    STUFF_DEFINE_EXCEPTION(multi_matcher_error, core::generic_error);
+
+    //
+    // Find any of many patterns (e.g., a few hundred symbols) in a single
+    // pass over a string (i.e., Aho-Corasick compiled to a table of states).
+    //
+    // This is meant to be a filter that runs before anything else: most
+    // strings that do not match are rejected at the cost of one table lookup
+    // per character. Runs of characters that can not start a pattern (e.g.,
+    // digits and separators when the patterns are symbols) are skipped 32 at
+    // a time when the CPU supports AVX2.
+    //
+    // For example:
+    //   multi_matcher symbols {"EUR/USD", "USD/JPY"};
+    //   if (symbols.contains(line)) {
+    //       ...
+    //   }
+    //
+    class multi_matcher {
+    public:
+        struct match {
+            std::size_t pattern;  // index of the pattern (in given order)
+            std::size_t position; // where the pattern starts in the string
+        };
+
+        //
+        // Compile the patterns; throws multi_matcher_error if a pattern is
+        // empty. The patterns are copied.
+        //
+        multi_matcher(std::initializer_list<std::string_view> patterns);
+
+        template <typename InputIt>
+        multi_matcher(InputIt first, InputIt last)
+        {
+            for (; first != last; ++first) {
+                add(*first);
+            }
+            compile();
+        }
+
+        //
+        // Return true if any pattern is in view.
+        //
+        [[nodiscard]] inline bool contains(std::string_view view) const noexcept
+        {
+            return find(view).has_value();
+        }
+
+        //
+        // Return the pattern that ends first in view (the longest, if more
+        // than one ends at the same character) or nothing.
+        //
+        [[nodiscard]] std::optional<match> find(
+            std::string_view view) const noexcept;
+
+        [[nodiscard]] inline std::size_t size() const noexcept
+        {
+            return m_lengths.size();
+        }
+
+    private:
+        using state_type = std::uint32_t;
+
+        void add(std::string_view pattern);
+        void compile();
+
+        // skip characters that can not start a pattern
+        [[nodiscard]] std::size_t skip(
+            const char* p, std::size_t i, std::size_t n) const noexcept;
+
+        std::vector<std::string>      m_patterns; // only while compiling
+        std::vector<std::size_t>      m_lengths;
+        std::array<std::uint8_t, 256> m_class {}; // character -> column
+        std::size_t                   m_classes {1};
+        std::vector<state_type>       m_next;   // state x column -> state
+        std::vector<std::uint32_t>    m_output; // pattern + 1 or 0 (none)
+        std::array<bool, 256>         m_is_start {};
+        std::array<std::uint8_t, 16>  m_start_low {}; // see skip()
+        std::array<std::uint8_t, 16>  m_start_high {};
+        bool                          m_ascii_start {true};
+
+    }; // class multi_matcher
+
+} // namespace stuff::string
+
+#endif // STUFF_STRING_MATCH_H
@@ -0,0 +1,207 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <cstddef>
+#include <string_view>
+#include <stuff/string/convert.h>
+#include <stuff/string/split.h>
+#include <system_error>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#ifndef STUFF_STRING_RECORD_H
+    #define STUFF_STRING_RECORD_H
+
+namespace stuff::string {
+
+    //
+    // How parse_record() converts a field to a T. Specialize this for other
+    // types with a static, noexcept convert() function like those below
+    // (e.g., stuff/datetime/conversions.h does so for sys_time).
+    //
+    template <typename T, typename Enable = void>
+    struct field_converter;
+
+    template <typename T>
+    struct field_converter<T, std::enable_if_t<std::is_arithmetic_v<T>>> {
+        [[nodiscard]] static inline conversion_result<T> convert(
+            std::string_view view) noexcept
+        {
+            return try_to_number<T>(view);
+        }
+    };
+
+    // Note: Non-owning; the field points into the record's string.
+    template <>
+    struct field_converter<std::string_view> {
+        [[nodiscard]] static inline conversion_result<std::string_view> convert(
+            std::string_view view) noexcept
+        {
+            return conversion_result<std::string_view> {view};
+        }
+    };
+
+    //
+    // The fields of a struct for parse_record(), in order, as a tuple of
+    // pointers to members. For example:
+    //   struct quote {
+    //       sys_time         time;
+    //       std::string_view symbol;
+    //       double           bid;
+    //   };
+    //
+    //   template <>
+    //   struct stuff::string::record_fields<quote> {
+    //       static constexpr auto members =
+    //           std::make_tuple(&quote::time, &quote::symbol, &quote::bid);
+    //   };
+    //
+    // Tuples (e.g., std::tuple<std::int64_t, double>) need no specialization.
+    //
+    template <typename Record>
+    struct record_fields;
+
+    //
+    // Result of parse_record(): the record or an error code (the same as the
+    // conversion of the field) and the zero-based index of the field that
+    // could not be converted. A missing field or extra fields are
+    // invalid_argument. Converts to true on success.
+    //
+    template <typename Record>
+    struct record_result {
+        Record      value {};
+        std::errc   ec {};
+        std::size_t field {0};
+
+        [[nodiscard]] inline explicit operator bool() const noexcept
+        {
+            return ec == std::errc {};
+        }
+    };
+
+    //
+    // Helper's for this library. Do not call from outside this library.
+    //
+    namespace detail {
+
+        template <typename Record, typename = void>
+        struct has_record_fields : std::false_type {};
+
+        template <typename Record>
+        struct has_record_fields<Record,
+            std::void_t<decltype(record_fields<Record>::members)>>
+        : std::true_type {};
+
+        template <typename Record>
+        inline constexpr std::size_t field_count = []() {
+            if constexpr (has_record_fields<Record>::value) {
+                return std::tuple_size_v<
+                    std::decay_t<decltype(record_fields<Record>::members)>>;
+            }
+            else {
+                return std::tuple_size_v<Record>;
+            }
+        }();
+
+        template <std::size_t I, typename Record>
+        [[nodiscard]] inline auto& get_field(Record& record) noexcept
+        {
+            if constexpr (has_record_fields<Record>::value) {
+                return record.*std::get<I>(record_fields<Record>::members);
+            }
+            else {
+                return std::get<I>(record);
+            }
+        }
+
+        template <std::size_t I, typename Record, typename Separator>
+        [[nodiscard]] inline bool parse_field(string_tokenizer& stok,
+            const Separator& sep, record_result<Record>& result) noexcept
+        {
+            auto& field = get_field<I>(result.value);
+            if (stok.is_done()) {
+                result.ec    = std::errc::invalid_argument;
+                result.field = I;
+                return false;
+            }
+
+            using T        = std::decay_t<decltype(field)>;
+            auto converted = field_converter<T>::convert(stok.next(sep));
+            if (!converted) {
+                result.ec    = converted.ec;
+                result.field = I;
+                return false;
+            }
+            field = converted.value;
+            return true;
+        }
+
+        template <typename Record, typename Separator, std::size_t... I>
+        [[nodiscard]] inline bool parse_fields(string_tokenizer& stok,
+            const Separator& sep, record_result<Record>& result,
+            std::index_sequence<I...>) noexcept
+        {
+            // in order and stops at the first error
+            return (parse_field<I>(stok, sep, result) && ...);
+        }
+
+    } // namespace detail
+
+    //
+    // Parse a record (e.g., a line of a CSV file) in a single pass: each field
+    // is converted by the fastest converter for its type as soon as it is
+    // found, and nothing is allocated or thrown. Because the whole record is
+    // known at compile time, the compiler can specialize the parser for it.
+    //
+    // For example:
+    //   using quote = std::tuple<std::int64_t, double, sys_time,
+    //       std::string_view>;
+    //   auto result = parse_record<quote>(line, ',');
+    //   if (result) {
+    //       auto& [id, price, time, symbol] = result.value;
+    //       ...
+    //   }
+    //
+    // Parameters:
+    //   Record  Type of the record: a tuple or a struct with record_fields.
+    //   view    String to parse; it must have exactly one token per field.
+    //   sep     Separator of the fields: a char or a string_separator.
+    //
+    // Returns:
+    //   The record or the error (see record_result).
+    //
+    template <typename Record, typename Separator = char>
+    [[nodiscard]] inline record_result<Record> parse_record(
+        std::string_view view, const Separator& sep = ' ') noexcept
+    {
+        constexpr auto count = detail::field_count<Record>;
+
+        record_result<Record> result;
+        string_tokenizer      stok {view};
+        if (detail::parse_fields(
+                stok, sep, result, std::make_index_sequence<count> {})
+            && !stok.is_done()) {
+            result.ec    = std::errc::invalid_argument;
+            result.field = count;
+        }
+        return result;
+    }
+
+} // namespace stuff::string
+
+#endif // STUFF_STRING_RECORD_H
@@ -15,6 +15,11 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <string_view>
 #include <stuff/container/string_array.h>
@@ -24,6 +29,48 @@
 
 namespace stuff::string {
 
+    //
+    // A separator of more than one character (e.g., "||", "\r\n", or "::")
+    // for string_tokenizer and split_view. Note: Non-owning; the string to
+    // which sep points must outlive this instance.
+    //
+    // Finding the separator is fast: short separators are found by comparing
+    // their first and last characters against 16 positions at once (SSE2)
+    // and only checking the middle of the candidates; long separators use
+    // Boyer-Moore-Horspool. An empty separator is never found.
+    //
+    // Copies are cheap (a view and a pointer): the skip table of a long
+    // separator is made once and shared by its copies (e.g., in split_view
+    // and its iterators).
+    //
+    class string_separator {
+    public:
+        string_separator() noexcept = default;
+        explicit string_separator(std::string_view sep);
+
+        //
+        // Return the position of the first occurrence of the separator in
+        // view or std::string_view::npos.
+        //
+        [[nodiscard]] std::size_t find(std::string_view view) const noexcept;
+
+        [[nodiscard]] inline std::size_t size() const noexcept
+        {
+            return m_sep.size();
+        }
+        [[nodiscard]] inline std::string_view view() const noexcept
+        {
+            return m_sep;
+        }
+
+    private:
+        using skip_table = std::array<std::uint8_t, 256>;
+
+        std::string_view                  m_sep;
+        std::shared_ptr<const skip_table> m_skip; // only for long separators
+
+    }; // class string_separator
+
     //
     // Non-owning string tokenizer (i.e., split a string into parts).
     //
@@ -60,6 +107,30 @@ namespace stuff::string {
         std::string_view next(char sep = ' ');
         std::string_view next(std::string_view sep_list);
 
+        //
+        // Same as above, but the separator is a string (e.g., "||") rather
+        // than a character.
+        //
+        std::string_view next(const string_separator& sep);
+
+        //
+        // Skip the next n tokens without building them, which is much faster
+        // than calling next() n times (e.g., to reach a column of a wide
+        // record). Afterward, head() is empty and tail() is the rest of the
+        // string.
+        //
+        // Returns:
+        //   The number of tokens skipped; less than n if the string ran out.
+        //
+        std::size_t skip(std::size_t n, char sep = ' ');
+
+        //
+        // Return the k-th (zero-based) token from here (i.e., field(0, sep)
+        // is the same as next(sep)) or an empty view if there are k or fewer
+        // tokens left.
+        //
+        std::string_view field(std::size_t k, char sep = ' ');
+
         //
         // Has the entire string been tokenized?
         //
@@ -129,6 +200,152 @@ namespace stuff::string {
     [[nodiscard]] container::string_view_array split_string(
         std::string_view view, char sep);
 
+    //
+    // Same as above, but write the tokens into result (which is cleared
+    // first). When result is reused from one call to the next, its capacity is
+    // kept and no allocation happens once it is large enough. Using a
+    // small_string_view_array avoids the heap entirely for short records.
+    //
+    // Parameters:
+    //   view    String to tokenize.
+    //   sep     Separator that divides each token.
+    //   result  Array that receives each token.
+    //
+    void split_string(std::string_view view, char sep,
+        container::string_view_array& result);
+    void split_string(std::string_view view, char sep,
+        container::small_string_view_array& result);
+
+    //
+    // Lazy, non-owning range over the tokens of a string.
+    //
+    // Unlike split_string(std::string_view, char), nothing is allocated: each
+    // token is found as the range is iterated, so a loop that breaks early
+    // (or an algorithm like std::find) never scans the rest of the string.
+    // The tokens are the same as those produced by split_string().
+    //
+    // The separator may be a char, a list of chars (as a std::string_view), or
+    // a string_separator (i.e., the same as string_tokenizer::next()).
+    //
+    // For example:
+    //   for (auto field : split_view(line, ',')) {
+    //       ...
+    //   }
+    // or
+    //   for (auto field : split_view(line, string_separator {"||"})) {
+    //       ...
+    //   }
+    //
+    template <typename Separator = char>
+    class split_view {
+    public:
+        class iterator {
+        public:
+            using iterator_category = std::forward_iterator_tag;
+            using value_type        = std::string_view;
+            using difference_type   = std::ptrdiff_t;
+            using pointer           = const std::string_view*;
+            using reference         = const std::string_view&;
+
+            //
+            // A default constructed iterator is the end of any split_view.
+            //
+            iterator() noexcept : m_stok {std::string_view {}} {}
+
+            iterator(std::string_view view, const Separator& sep)
+            : m_stok {view}, m_sep {sep}, m_is_end {false}
+            {
+                m_head = m_stok.next(m_sep);
+            }
+
+            [[nodiscard]] inline reference operator*() const noexcept
+            {
+                return m_head;
+            }
+
+            [[nodiscard]] inline pointer operator->() const noexcept
+            {
+                return &m_head;
+            }
+
+            inline iterator& operator++()
+            {
+                if (m_stok.is_done()) {
+                    m_is_end = true;
+                }
+                else {
+                    m_head = m_stok.next(m_sep);
+                }
+                return *this;
+            }
+
+            inline iterator operator++(int)
+            {
+                iterator tmp {*this};
+                ++*this;
+                return tmp;
+            }
+
+            [[nodiscard]] friend inline bool operator==(
+                const iterator& lhs, const iterator& rhs) noexcept
+            {
+                if (lhs.m_is_end || rhs.m_is_end) {
+                    return lhs.m_is_end == rhs.m_is_end;
+                }
+                // every token starts at a unique position in the string
+                return lhs.m_head.data() == rhs.m_head.data();
+            }
+
+            [[nodiscard]] friend inline bool operator!=(
+                const iterator& lhs, const iterator& rhs) noexcept
+            {
+                return !(lhs == rhs);
+            }
+
+        private:
+            string_tokenizer m_stok;
+            std::string_view m_head;
+            Separator        m_sep {};
+            bool             m_is_end {true};
+
+        }; // class iterator
+
+        split_view(std::string_view view, Separator sep) noexcept
+        : m_view {view}, m_sep {sep}
+        {
+        }
+
+        [[nodiscard]] inline iterator begin() const
+        {
+            return iterator {m_view, m_sep};
+        }
+        [[nodiscard]] inline iterator end() const noexcept
+        {
+            return iterator {};
+        }
+
+    private:
+        std::string_view m_view;
+        Separator        m_sep;
+
+    }; // class split_view
+
+    //
+    // Return the k-th (zero-based) token of a string without looking past it.
+    // This is much faster than splitting the whole string when only a few
+    // columns of a wide record are needed. Note: Non-owning.
+    //
+    // Parameters:
+    //   view  String to tokenize.
+    //   sep   Separator that divides each token.
+    //   k     Index of the token to return.
+    //
+    // Returns:
+    //   The k-th token or an empty view if view has k or fewer tokens.
+    //
+    [[nodiscard]] std::string_view nth_field(
+        std::string_view view, char sep, std::size_t k) noexcept;
+
 } // namespace stuff::string
 
 #endif // STUFF_STRING_SPLIT_H
@@ -0,0 +1,356 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <limits>
+#include <stuff/core/cpu.h>
+#include <stuff/datetime/bucket.h>
+#include <stuff/datetime/datetime.h>
+
+namespace stuff::datetime {
+
+    namespace {
+
+        __extension__ using uint128 = unsigned __int128;
+
+        //
+        // Unsigned division by d as a multiply by a "magic" reciprocal and a
+        // shift (Granlund and Montgomery; as libdivide does it):
+        //   q = mulhi(u, magic); if add, q = ((u - q) / 2 + q); q >>= shift
+        // or just a shift if d is a power of 2.
+        //
+        struct divider {
+            std::uint64_t d {};
+            std::uint64_t magic {};
+            unsigned      shift {};
+            bool          add {};
+            bool          power_of_2 {};
+        };
+
+        divider make_divider(std::uint64_t d) noexcept
+        {
+            divider div;
+            div.d     = d;
+            div.shift = 63u - static_cast<unsigned>(__builtin_clzll(d));
+            if ((d & (d - 1)) == 0) {
+                div.power_of_2 = true;
+                return div;
+            }
+
+            // floor(2^(64 + shift) / d) fits in 64 bits as d > 2^shift
+            const auto n   = static_cast<uint128>(1) << (64 + div.shift);
+            auto       m   = static_cast<std::uint64_t>(n / d);
+            const auto rem = static_cast<std::uint64_t>(n % d);
+            if (d - rem >= (std::uint64_t {1} << div.shift)) {
+                // not precise enough with 64 bits: use 65 (i.e., add)
+                const auto twice_rem = rem + rem;
+                m += m;
+                if (twice_rem >= d || twice_rem < rem) {
+                    ++m;
+                }
+                div.add = true;
+            }
+            div.magic = m + 1;
+            return div;
+        }
+
+        inline std::uint64_t divide(
+            std::uint64_t u, const divider& div) noexcept
+        {
+            if (div.power_of_2) {
+                return u >> div.shift;
+            }
+            auto q = static_cast<std::uint64_t>(
+                (static_cast<uint128>(u) * div.magic) >> 64);
+            if (div.add) {
+                q = ((u - q) >> 1) + q;
+            }
+            return q >> div.shift;
+        }
+
+        //
+        // A floor division of the time since origin by size in unsigned
+        // arithmetic: biased by a multiple of size (about 2^63) so that the
+        // times before origin are positive, i.e., the bucket index is
+        //   divide(t - origin + bias) - bias / size
+        // for all but the times within size of the earliest time.
+        //
+        struct bucketer {
+            explicit bucketer(duration size, sys_time origin)
+            : div {make_divider(static_cast<std::uint64_t>(size.count()))}
+            , origin {static_cast<std::uint64_t>(
+                  origin.time_since_epoch().count())}
+            {
+                const auto d = div.d;
+                bias_index   = (std::uint64_t {1} << 63) / d;
+                bias         = bias_index * d;
+            }
+
+            // t - origin + bias (mod 2^64)
+            [[nodiscard]] std::uint64_t biased(sys_time t) const noexcept
+            {
+                return static_cast<std::uint64_t>(t.time_since_epoch().count())
+                       - origin + bias;
+            }
+
+            [[nodiscard]] std::int64_t index(sys_time t) const noexcept
+            {
+                return static_cast<std::int64_t>(
+                    divide(biased(t), div) - bias_index);
+            }
+
+            [[nodiscard]] sys_time start(sys_time t) const noexcept
+            {
+                const auto q = divide(biased(t), div);
+                return sys_time {duration {
+                    static_cast<std::int64_t>(q * div.d - bias + origin)}};
+            }
+
+            divider       div;
+            std::uint64_t origin;
+            std::uint64_t bias;
+            std::uint64_t bias_index;
+        };
+
+#if defined(STUFF_AVX2_DISPATCH)
+
+        // the high 64 bits of the 128 bit products of 4 pairs of 64 bits
+        STUFF_TARGET_AVX2 inline __m256i mulhi_avx2(__m256i x, __m256i y)
+        {
+            const auto low = _mm256_set1_epi64x(0xFFFFFFFF);
+            const auto xh  = _mm256_srli_epi64(x, 32);
+            const auto yh  = _mm256_srli_epi64(y, 32);
+            const auto w0  = _mm256_mul_epu32(x, y);
+            const auto w1  = _mm256_mul_epu32(x, yh);
+            const auto w2  = _mm256_mul_epu32(xh, y);
+            const auto w3  = _mm256_mul_epu32(xh, yh);
+
+            const auto s1 = _mm256_add_epi64(w1, _mm256_srli_epi64(w0, 32));
+            const auto s2 = _mm256_add_epi64(w2, _mm256_and_si256(s1, low));
+            return _mm256_add_epi64(
+                _mm256_add_epi64(w3, _mm256_srli_epi64(s1, 32)),
+                _mm256_srli_epi64(s2, 32));
+        }
+
+        // the low 64 bits of the products of 4 pairs of 64 bits
+        STUFF_TARGET_AVX2 inline __m256i mullo_avx2(__m256i x, __m256i y)
+        {
+            const auto cross = _mm256_add_epi64(
+                _mm256_mul_epu32(_mm256_srli_epi64(x, 32), y),
+                _mm256_mul_epu32(x, _mm256_srli_epi64(y, 32)));
+            return _mm256_add_epi64(
+                _mm256_mul_epu32(x, y), _mm256_slli_epi64(cross, 32));
+        }
+
+        //
+        // The bucket starts (or indexes) of the times in [0, count) (rounded
+        // down to 4 times); return how many.
+        //
+        template <bool Starts>
+        STUFF_TARGET_AVX2 std::size_t bucket_avx2(const sys_time* times,
+            std::size_t count, const bucketer& b, std::int64_t* out) noexcept
+        {
+            static_assert(sizeof(sys_time) == sizeof(std::int64_t));
+            const auto to_i64 = [](std::uint64_t u) {
+                return static_cast<long long>(u);
+            };
+            const auto magic = _mm256_set1_epi64x(to_i64(b.div.magic));
+            const auto d     = _mm256_set1_epi64x(to_i64(b.div.d));
+            const auto shift = _mm_cvtsi32_si128(static_cast<int>(b.div.shift));
+            const auto offset = _mm256_set1_epi64x(to_i64(b.bias - b.origin));
+            const auto unbias = _mm256_set1_epi64x(
+                to_i64(Starts ? b.bias - b.origin : b.bias_index));
+
+            std::size_t i = 0;
+            for (; i + 4 <= count; i += 4) {
+                const auto u = _mm256_add_epi64(
+                    _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(times + i)),
+                    offset);
+                __m256i q;
+                if (b.div.power_of_2) {
+                    q = _mm256_srl_epi64(u, shift);
+                }
+                else {
+                    q = mulhi_avx2(u, magic);
+                    if (b.div.add) {
+                        q = _mm256_add_epi64(
+                            _mm256_srli_epi64(_mm256_sub_epi64(u, q), 1), q);
+                    }
+                    q = _mm256_srl_epi64(q, shift);
+                }
+                if constexpr (Starts) {
+                    q = mullo_avx2(q, d);
+                }
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i),
+                    _mm256_sub_epi64(q, unbias));
+            }
+            return i;
+        }
+
+#endif
+
+        template <bool Starts, typename T>
+        void bucket(const sys_time* times, std::size_t count, duration size,
+            sys_time origin, T* out)
+        {
+            STUFF_EXPECTS(size.count() > 0, datetime_error,
+                "bucket size must be positive (not {}ns)", size.count());
+
+            const bucketer b {size, origin};
+            std::size_t    i = 0;
+#if defined(STUFF_AVX2_DISPATCH)
+            // (fewer than 16 times are not worth the AVX2 warm up)
+            if (core::detail::use_avx2(count, 16)) {
+                i = bucket_avx2<Starts>(
+                    times, count, b, reinterpret_cast<std::int64_t*>(out));
+            }
+#endif
+            for (; i < count; ++i) {
+                if constexpr (Starts) {
+                    out[i] = b.start(times[i]);
+                }
+                else {
+                    out[i] = b.index(times[i]);
+                }
+            }
+        }
+
+        // the first day of the bucket of the local day
+        local_days first_day(local_days day, calendar_interval interval)
+        {
+            switch (interval) {
+            case calendar_interval::day:
+                return day;
+            case calendar_interval::week:
+                return find_sunday(day);
+            case calendar_interval::month:
+                break;
+            }
+            const date::year_month_day ymd {day};
+            return local_days {ymd.year() / ymd.month() / 1};
+        }
+
+        // the first day of the bucket after the one that starts on day
+        local_days next_day(local_days day, calendar_interval interval)
+        {
+            switch (interval) {
+            case calendar_interval::day:
+                return day + date::days {1};
+            case calendar_interval::week:
+                return day + date::days {7};
+            case calendar_interval::month:
+                break;
+            }
+            return local_days {date::year_month_day {day} + date::months {1}};
+        }
+
+    } // namespace
+
+    void floor_times(const sys_time* times, std::size_t count, duration size,
+        sys_time* starts, sys_time origin)
+    {
+        static_assert(sizeof(sys_time) == sizeof(std::int64_t));
+        bucket<true>(times, count, size, origin, starts);
+    }
+
+    std::vector<sys_time> floor_times(
+        const std::vector<sys_time>& times, duration size, sys_time origin)
+    {
+        std::vector<sys_time> starts(times.size());
+        floor_times(times.data(), times.size(), size, starts.data(), origin);
+        return starts;
+    }
+
+    void bucket_indexes(const sys_time* times, std::size_t count,
+        duration size, std::int64_t* indexes, sys_time origin)
+    {
+        bucket<false>(times, count, size, origin, indexes);
+    }
+
+    std::vector<std::int64_t> bucket_indexes(
+        const std::vector<sys_time>& times, duration size, sys_time origin)
+    {
+        std::vector<std::int64_t> indexes(times.size());
+        bucket_indexes(
+            times.data(), times.size(), size, indexes.data(), origin);
+        return indexes;
+    }
+
+    void floor_times(const sys_time* times, std::size_t count,
+        calendar_interval interval, const fast_zone& zone, sys_time* starts)
+    {
+        // the bucket of the time before: [begin, end)
+        auto begin = sys_time::max();
+        auto end   = sys_time::min();
+        for (std::size_t i = 0; i < count; ++i) {
+            const auto t = times[i];
+            if (t < begin || t >= end) {
+                const auto day = first_day(
+                    date::floor<date::days>(zone.to_local(t)), interval);
+                begin = zone.to_sys(local_time {day}, local_policy::earliest);
+                end   = zone.to_sys(local_time {next_day(day, interval)},
+                    local_policy::earliest);
+            }
+            starts[i] = begin;
+        }
+    }
+
+    std::vector<sys_time> floor_times(const std::vector<sys_time>& times,
+        calendar_interval interval, const fast_zone& zone)
+    {
+        std::vector<sys_time> starts(times.size());
+        floor_times(times.data(), times.size(), interval, zone, starts.data());
+        return starts;
+    }
+
+    ohlcv_resampler::ohlcv_resampler(duration size, sys_time origin)
+    : m_size {size}
+    , m_origin {origin}
+    {
+        STUFF_EXPECTS(size.count() > 0, datetime_error,
+            "bucket size must be positive (not {}ns)", size.count());
+    }
+
+    ohlcv_resampler::ohlcv_resampler(
+        calendar_interval interval, const fast_zone& zone)
+    : m_interval {interval}
+    , m_zone {&zone}
+    {
+    }
+
+    void ohlcv_resampler::floor(
+        const sys_time* times, std::size_t count, sys_time* starts) const
+    {
+        if (m_zone != nullptr) {
+            floor_times(times, count, m_interval, *m_zone, starts);
+        }
+        else {
+            floor_times(times, count, m_size, starts, m_origin);
+        }
+    }
+
+    sys_time ohlcv_resampler::bucket_end(sys_time start) const
+    {
+        if (m_zone == nullptr) {
+            return start + m_size;
+        }
+        const auto day = date::floor<date::days>(m_zone->to_local(start));
+        return m_zone->to_sys(
+            local_time {next_day(day, m_interval)}, local_policy::earliest);
+    }
+
+} // namespace stuff::datetime
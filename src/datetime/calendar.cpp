@@ -0,0 +1,248 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <limits>
+#include <stuff/datetime/calendar.h>
+#include <stuff/datetime/conversions.h>
+#include <stuff/datetime/zone.h>
+
+namespace stuff::datetime {
+
+    namespace {
+
+        constexpr auto one_day = std::chrono::hours {24};
+
+    } // namespace
+
+    namespace detail {
+
+        session_table::session_table(
+            sys_time begin, sys_time end, std::vector<session> sessions)
+        : m_begin {begin}
+        , m_end {std::max(begin, end)}
+        {
+            std::sort(sessions.begin(), sessions.end(),
+                [](const auto& a, const auto& b) { return a.open < b.open; });
+            for (const auto& s : sessions) {
+                if (s.open >= s.close) {
+                    continue;
+                }
+                if (!m_bells.empty() && s.open <= m_bells.back()) {
+                    m_bells.back() = std::max(m_bells.back(), s.close);
+                    continue;
+                }
+                m_bells.push_back(s.open);
+                m_bells.push_back(s.close);
+            }
+            STUFF_EXPECTS(
+                m_bells.size() < std::numeric_limits<std::uint32_t>::max(),
+                datetime_error, "too many sessions");
+
+            // the time open at each open (the same as at the close before)
+            // and close
+            m_open.reserve(m_bells.size());
+            duration open {0};
+            for (std::size_t i = 0; i < m_bells.size(); ++i) {
+                if (i % 2 == 1) {
+                    open += m_bells[i] - m_bells[i - 1];
+                }
+                m_open.push_back(open);
+            }
+
+            // the number of bells before the start of every day
+            const auto  days = (m_end - m_begin) / one_day;
+            std::size_t i    = 0;
+            m_days.reserve(static_cast<std::size_t>(days));
+            for (std::int64_t d = 0; d < days; ++d) {
+                const auto start = m_begin + one_day * d;
+                while (i < m_bells.size() && m_bells[i] < start) {
+                    ++i;
+                }
+                m_days.push_back(static_cast<std::uint32_t>(i));
+            }
+        }
+
+        std::size_t session_table::find(sys_time t) const noexcept
+        {
+            if (!in_range(t)) {
+                return static_cast<std::size_t>(
+                    std::upper_bound(m_bells.begin(), m_bells.end(), t)
+                    - m_bells.begin());
+            }
+
+            const auto  day = static_cast<std::size_t>((t - m_begin) / one_day);
+            std::size_t i   = m_days[day];
+            while (i < m_bells.size() && m_bells[i] <= t) {
+                ++i;
+            }
+            return i;
+        }
+
+        std::optional<session> session_table::session_of(
+            sys_time t) const noexcept
+        {
+            const auto i = find(t);
+            if ((i & 1) == 0) {
+                return std::nullopt;
+            }
+            return session {m_bells[i - 1], m_bells[i]};
+        }
+
+        std::optional<sys_time> session_table::next_open(
+            sys_time t) const noexcept
+        {
+            // the close of the session t is in comes first
+            const auto i = find(t);
+            const auto j = i + (i & 1);
+            if (j >= m_bells.size()) {
+                return std::nullopt;
+            }
+            return m_bells[j];
+        }
+
+        duration session_table::open_time(sys_time t) const noexcept
+        {
+            const auto i = find(t);
+            if (i == 0) {
+                return duration {0};
+            }
+            const auto before = m_open[i - 1];
+            return (i & 1) != 0 ? before + (t - m_bells[i - 1]) : before;
+        }
+
+    } // namespace detail
+
+    trading_calendar::trading_calendar(
+        const venue_rules& rules, date::year first, date::year last)
+    : m_name {rules.name}
+    {
+        STUFF_EXPECTS(first <= last, datetime_error, "{} is after {}",
+            static_cast<int>(first), static_cast<int>(last));
+        STUFF_EXPECTS(!rules.sessions.empty(), datetime_error,
+            "{} has no sessions", m_name);
+        for (const auto& hours : rules.sessions) {
+            STUFF_EXPECTS(hours.open < hours.close && hours.open >= -one_day
+                              && hours.close <= one_day * 2,
+                datetime_error, "bad session in {}", m_name);
+        }
+
+        const auto& zone     = locate_fast_zone(rules.zone);
+        auto        holidays = rules.holidays;
+        std::sort(holidays.begin(), holidays.end());
+        auto early_closes = rules.early_closes;
+        std::sort(early_closes.begin(), early_closes.end(),
+            [](const auto& a, const auto& b) { return a.day < b.day; });
+
+        // the sessions of every trading day, with a few more days on each
+        // side for sessions that start the day before (and time zones)
+        const sys_days begin {first / date::January / 1};
+        const sys_days end {(last + date::years {1}) / date::January / 1};
+        const auto     extra = date::days {3};
+
+        std::vector<session> sessions;
+        auto                 early = early_closes.begin();
+        for (auto day = local_days {begin.time_since_epoch()} - extra;
+             day < local_days {end.time_since_epoch()} + extra;
+             day += date::days {1}) {
+            const date::weekday weekday {day};
+            if (std::find(rules.weekdays.begin(), rules.weekdays.end(),
+                    weekday)
+                    == rules.weekdays.end()
+                || std::binary_search(holidays.begin(), holidays.end(), day)) {
+                continue;
+            }
+
+            while (early != early_closes.end() && early->day < day) {
+                ++early;
+            }
+            auto close_by = duration::max();
+            if (early != early_closes.end() && early->day == day) {
+                close_by = early->close;
+            }
+
+            for (const auto& hours : rules.sessions) {
+                const auto close = std::min(hours.close, close_by);
+                if (hours.open >= close) {
+                    continue;
+                }
+                sessions.push_back(
+                    {zone.to_sys(day + hours.open, local_policy::earliest),
+                        zone.to_sys(day + close, local_policy::earliest)});
+            }
+        }
+
+        m_table = detail::session_table {begin, end, std::move(sessions)};
+    }
+
+    void trading_calendar::expects_in_range(sys_time t) const
+    {
+        STUFF_EXPECTS(m_table.in_range(t), datetime_error,
+            "{} is outside the calendar of {}", to_string(t), m_name);
+    }
+
+    bool trading_calendar::is_open(sys_time t) const
+    {
+        expects_in_range(t);
+        return m_table.is_open(t);
+    }
+
+    std::optional<session> trading_calendar::session_of(sys_time t) const
+    {
+        expects_in_range(t);
+        return m_table.session_of(t);
+    }
+
+    sys_time trading_calendar::next_open(sys_time t) const
+    {
+        expects_in_range(t);
+        const auto open = m_table.next_open(t);
+        STUFF_EXPECTS(open && m_table.in_range(*open), datetime_error,
+            "{} has no open after {}", m_name, to_string(t));
+        return *open;
+    }
+
+    duration trading_calendar::duration_between(
+        sys_time from, sys_time to) const
+    {
+        expects_in_range(from);
+        expects_in_range(to);
+        return m_table.open_time(to) - m_table.open_time(from);
+    }
+
+    void trading_calendar::classify(
+        const sys_time* times, std::size_t count, bool* open) const
+    {
+        m_table.classify(times, count, [&](std::size_t k, bool is) {
+            expects_in_range(times[k]);
+            open[k] = is;
+        });
+    }
+
+    std::vector<bool> trading_calendar::classify(
+        const std::vector<sys_time>& times) const
+    {
+        std::vector<bool> open(times.size());
+        m_table.classify(times.data(), times.size(),
+            [&](std::size_t k, bool is) {
+                expects_in_range(times[k]);
+                open[k] = is;
+            });
+        return open;
+    }
+
+} // namespace stuff::datetime
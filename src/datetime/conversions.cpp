@@ -15,18 +15,22 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <future>
+#include <limits>
+#include <stuff/core/cpu.h>
 #include <stuff/datetime/conversions.h>
+#include <stuff/datetime/datetime.h>
+#include <stuff/datetime/zone.h>
 #include <stuff/string/convert.h>
+#include <stuff/string/format.h>
 #include <stuff/string/split.h>
+#include <thread>
 
 namespace stuff::datetime {
 
-    // {year}-{month}-{day}T{hour}:{minute}:{second}.{nanoseconds}{zone}
-    const char* sys_fmt_str {"{}-{:02d}-{:02d}T{:02d}:{:02d}:{:02d}.{:09d}Z"};
-    const char* local_fmt_str {"{}-{:02d}-{:02d}T{:02d}:{:02d}:{:02d}.{:09d}"};
-    const char* zoned_fmt_str {
-        "{}-{:02d}-{:02d}T{:02d}:{:02d}:{:02d}.{:09d} {}"};
-
     namespace detail {
 
         date::year to_year(std::string_view view)
@@ -78,103 +82,715 @@ namespace stuff::datetime {
 
     } // namespace detail
 
-    sys_time to_sys_time(std::string_view view)
-    {
-        try {
-            sys_time                 result;
-            string::string_tokenizer tok {view};
+    namespace {
+
+        //
+        // SWAR (i.e., SIMD within a register) helpers for the fixed layout
+        // "YYYY-MM-DDTHH:MM:SS.fffffffffZ": eight characters are checked and
+        // converted at once as a 64-bit integer.
+        //
+
+        inline std::uint64_t load8(const char* p) noexcept
+        {
+            std::uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            v = __builtin_bswap64(v);
+#endif
+            return v;
+        }
+
+        // true if all eight characters are digits
+        inline bool all_digits(std::uint64_t v) noexcept
+        {
+            return ((v & 0xF0F0F0F0F0F0F0F0)
+                       | (((v + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0)
+                           >> 4))
+                   == 0x3333333333333333;
+        }
+
+        // eight digits as four two-digit numbers, one per 16 bits
+        inline std::uint64_t to_pairs(std::uint64_t v) noexcept
+        {
+            return (((v & 0x0F0F0F0F0F0F0F0F) * 2561) >> 8)
+                   & 0x00FF00FF00FF00FF;
+        }
+
+        inline unsigned pair(std::uint64_t pairs, int k) noexcept
+        {
+            return static_cast<unsigned>((pairs >> (16 * k)) & 0xFF);
+        }
+
+        inline std::uint32_t to_eight_digits(std::uint64_t v) noexcept
+        {
+            v = (to_pairs(v) * 6553601) >> 16;
+            return static_cast<std::uint32_t>(
+                ((v & 0x0000FFFF0000FFFF) * 42949672960001) >> 32);
+        }
+
+        //
+        // Days since 1970-01-01 of a date in the proleptic Gregorian calendar
+        // (see http://howardhinnant.github.io/date_algorithms.html).
+        //
+        constexpr long days_from_civil(int y, unsigned m, unsigned d) noexcept
+        {
+            y -= m <= 2;
+            const long     era = (y >= 0 ? y : y - 399) / 400;
+            const auto     yoe = static_cast<unsigned>(y - era * 400);
+            const unsigned mp  = m > 2 ? m - 3 : m + 9; // March is 0
+            const unsigned doy = (153 * mp + 2) / 5 + d - 1;
+            const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+            return era * 146097 + static_cast<long>(doe) - 719468;
+        }
+
+        // the date of days since 1970-01-01 (the inverse of days_from_civil())
+        struct civil_date {
+            int      year;
+            unsigned month;
+            unsigned day;
+        };
+
+        constexpr civil_date civil_from_days(long days) noexcept
+        {
+            days += 719468;
+            const long     era = (days >= 0 ? days : days - 146096) / 146097;
+            const auto     doe = static_cast<unsigned>(days - era * 146097);
+            const unsigned yoe =
+                (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+            const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+            const unsigned mp  = (5 * doy + 2) / 153; // March is 0
+            const unsigned d   = doy - (153 * mp + 2) / 5 + 1;
+            const unsigned m   = mp < 10 ? mp + 3 : mp - 9;
+            return {static_cast<int>(yoe + era * 400 + (m <= 2)), m, d};
+        }
+
+        constexpr std::int64_t ns_per_second = 1000000000;
+        constexpr std::int64_t ns_per_day    = 86400 * ns_per_second;
+
+        //
+        // The time since the epoch of seconds and nanoseconds since it, or
+        // false if sys_time cannot hold it. The seconds are not scaled on
+        // their own: midnight of 1677-09-21 (the day of sys_time::min()) is
+        // out of range, but most of that day is not.
+        //
+        [[nodiscard]] inline bool to_duration(
+            std::int64_t seconds, std::int64_t ns, duration& result) noexcept
+        {
+            // borrow a second, so the product fits whenever the sum does
+            if (seconds < 0 && ns > 0) {
+                ++seconds;
+                ns -= ns_per_second;
+            }
+            std::int64_t count;
+            if (__builtin_mul_overflow(seconds, ns_per_second, &count)
+                || __builtin_add_overflow(count, ns, &count)) {
+                return false;
+            }
+            result = duration {count};
+            return true;
+        }
+
+        // the same for a date, a time of day (in seconds) and nanoseconds
+        [[nodiscard]] inline bool to_duration(int year, unsigned month,
+            unsigned day, long seconds, long ns, duration& result) noexcept
+        {
+            return to_duration(
+                days_from_civil(year, month, day) * 86400 + seconds, ns,
+                result);
+        }
+
+        // the sizes of the fixed layouts (without 'Z') and of their date
+        constexpr std::size_t fixed_date_size        = 10;
+        constexpr std::size_t fixed_seconds_size     = 19;
+        constexpr std::size_t fixed_nanoseconds_size = 29;
+
+        //
+        // The size of view (without the 'Z', which is optional if zone is
+        // true) if it is one of the fixed layouts, or 0 if it is not.
+        //
+        inline std::size_t fixed_size(std::string_view view, bool zone) noexcept
+        {
+            auto n = view.size();
+            if (zone && n > 0 && view.back() == 'Z') {
+                --n;
+            }
+            if (n != fixed_seconds_size && n != fixed_nanoseconds_size) {
+                return 0;
+            }
+            return n;
+        }
+
+        //
+        // Parse "YYYY-MM-DD" at p into days since the epoch. Returns false if
+        // the characters are not in that layout or the month or day is out of
+        // range.
+        //
+        [[nodiscard]] bool parse_fixed_date(
+            const char* p, std::int64_t& days) noexcept
+        {
+            if (p[4] != '-' || p[7] != '-') {
+                return false;
+            }
+
+            // gather "YYYYMMDD" from "YYYY-MM-" and "YY-MM-DD"
+            const auto ym  = load8(p);
+            const auto md  = load8(p + 2);
+            const auto ymd = (ym & 0x00000000FFFFFFFF)
+                             | ((ym >> 8) & 0x0000FFFF00000000)
+                             | (md & 0xFFFF000000000000);
+            if (!all_digits(ymd)) {
+                return false;
+            }
+
+            const auto pairs   = to_pairs(ymd);
+            const auto century = pair(pairs, 0);
+            const auto year    = pair(pairs, 1);
+            const auto month   = pair(pairs, 2);
+            const auto day     = pair(pairs, 3);
+            if (month < 1 || month > 12 || day < 1 || day > 31) {
+                return false;
+            }
+            days = days_from_civil(
+                static_cast<int>(century * 100 + year), month, day);
+            return true;
+        }
+
+        //
+        // Parse the rest of a fixed layout of size n at p, "THH:MM:SS" or
+        // "THH:MM:SS.fffffffff" (or with ' ' for 'T'), into the time of day
+        // in seconds and nanoseconds.
+        //
+        [[nodiscard]] bool parse_fixed_time(const char* p, std::size_t n,
+            std::int64_t& seconds, std::int64_t& ns) noexcept
+        {
+            const bool date_sep = p[10] == 'T' || p[10] == ' ';
+            if (!date_sep || p[13] != ':' || p[16] != ':') {
+                return false;
+            }
+
+            // gather "HHMMSS00" from "HH:MM:SS"
+            const auto time = load8(p + 11);
+            const auto hms  = (time & 0x000000000000FFFF)
+                             | ((time >> 8) & 0x00000000FFFF0000)
+                             | ((time >> 16) & 0x0000FFFF00000000)
+                             | 0x3030000000000000;
+            if (!all_digits(hms)) {
+                return false;
+            }
+            const auto pairs = to_pairs(hms);
+            seconds = pair(pairs, 0) * 3600L + pair(pairs, 1) * 60
+                      + pair(pairs, 2);
+            ns = 0;
+
+            if (n == fixed_nanoseconds_size) {
+                p += fixed_seconds_size;
+                const auto digits = load8(p + 1);
+                const auto last   = static_cast<unsigned char>(p[9]) - '0';
+                if (p[0] != '.' || !all_digits(digits) || last > 9) {
+                    return false;
+                }
+                ns = std::int64_t {to_eight_digits(digits)} * 10 + last;
+            }
+            return true;
+        }
+
+        //
+        // Parse the fixed layouts (i.e., to the second or nanosecond, with
+        // an optional 'Z' if zone is true) into the time since the epoch.
+        // Returns false for any other string (or a time out of range), which
+        // must be left to the general (tokenizing) parser; it may still be
+        // valid.
+        //
+        [[nodiscard]] bool parse_fixed(
+            std::string_view view, bool zone, duration& result) noexcept
+        {
+            const auto   n = fixed_size(view, zone);
+            std::int64_t days;
+            std::int64_t seconds;
+            std::int64_t ns;
+            return n != 0 && parse_fixed_date(view.data(), days)
+                   && parse_fixed_time(view.data(), n, seconds, ns)
+                   && to_duration(days * 86400 + seconds, ns, result);
+        }
+
+        //
+        // Non-throwing parse of "{year}-{month}-{day}T{hour}:{minute}:{second}"
+        // into seconds since the epoch. The seconds end at any of sec_seps,
+        // which leaves tok at the (optional) fraction of a second. Returns
+        // false if the seconds overflow (e.g., a huge number of hours).
+        //
+        [[nodiscard]] bool parse_date_time(string::string_tokenizer& tok,
+            std::string_view sec_seps, std::int64_t& result) noexcept
+        {
+            auto year    = string::try_to_number<int>(tok.next('-'));
+            auto month   = string::try_to_number<unsigned>(tok.next('-'));
+            auto day     = string::try_to_number<unsigned>(tok.next("T "));
+            auto hours   = string::try_to_number<long>(tok.next(':'));
+            auto minutes = string::try_to_number<long>(tok.next(':'));
+            auto seconds = string::try_to_number<long>(tok.next(sec_seps));
+            if (!year || !month || !day || !hours || !minutes || !seconds) {
+                return false;
+            }
+
+            auto ymd = date::year_month_day {date::year {year.value},
+                date::month {month.value}, date::day {day.value}};
+            result = std::int64_t {
+                         date::sys_days(ymd).time_since_epoch().count()}
+                     * 86400;
+            std::int64_t hms[3];
+            return !__builtin_mul_overflow(hours.value, 3600, &hms[0])
+                   && !__builtin_mul_overflow(minutes.value, 60, &hms[1])
+                   && !__builtin_add_overflow(hms[0], hms[1], &hms[2])
+                   && !__builtin_add_overflow(hms[2], seconds.value, &hms[2])
+                   && !__builtin_add_overflow(result, hms[2], &result);
+        }
+
+        //
+        // Non-throwing version of detail::to_nanoseconds().
+        //
+        [[nodiscard]] bool parse_nanoseconds(
+            std::string_view view, duration& result) noexcept
+        {
+            static constexpr std::array<long, 10> prec {0, 100000000, 10000000,
+                1000000, 100000, 10000, 1000, 100, 10, 1};
+
+            if (view.size() >= 10) {
+                return false;
+            }
+            auto ns = string::try_to_number<long>(view, 0);
+            if (!ns) {
+                return false;
+            }
+            result = std::chrono::nanoseconds(ns.value * prec[view.size()]);
+            return true;
+        }
+
+        // split the time since the epoch into days and nanoseconds of the day
+        inline std::int64_t split_days(
+            duration since_epoch, std::int64_t& ns) noexcept
+        {
+            auto days = since_epoch.count() / ns_per_day;
+            ns        = since_epoch.count() % ns_per_day;
+            if (ns < 0) {
+                ns += ns_per_day;
+                --days;
+            }
+            return days;
+        }
+
+        // write n (0 through 99) as two digits
+        inline char* write_pair(char* out, unsigned n) noexcept
+        {
+            std::memcpy(out, &string::detail::digit_pairs[n * 2], 2);
+            return out + 2;
+        }
+
+        // "YYYY-MM-DD" (nanosecond times are always four-digit years)
+        inline char* write_date(char* out, std::int64_t days) noexcept
+        {
+            const auto date = civil_from_days(static_cast<long>(days));
+            const auto year = static_cast<unsigned>(date.year);
+
+            out    = write_pair(out, year / 100);
+            out    = write_pair(out, year % 100);
+            *out++ = '-';
+            out    = write_pair(out, date.month);
+            *out++ = '-';
+            return write_pair(out, date.day);
+        }
+
+        // "THH:MM:SS.fffffffff"
+        inline char* write_time_of_day(char* out, std::int64_t ns) noexcept
+        {
+            const auto seconds  = static_cast<unsigned>(ns / ns_per_second);
+            const auto fraction = static_cast<unsigned>(ns % ns_per_second);
+
+            *out++ = 'T';
+            out    = write_pair(out, seconds / 3600);
+            *out++ = ':';
+            out    = write_pair(out, seconds / 60 % 60);
+            *out++ = ':';
+            out    = write_pair(out, seconds % 60);
+            *out++ = '.';
+            *out++ = static_cast<char>('0' + fraction / 100000000);
+            out    = write_pair(out, fraction / 1000000 % 100);
+            out    = write_pair(out, fraction / 10000 % 100);
+            out    = write_pair(out, fraction / 100 % 100);
+            return write_pair(out, fraction % 100);
+        }
+
+        inline char* write_date_time(char* out, duration since_epoch) noexcept
+        {
+            std::int64_t ns;
+            const auto   days = split_days(since_epoch, ns);
+            return write_time_of_day(write_date(out, days), ns);
+        }
+
+        //
+        // Convert strings [first, last) to times, where view(i) returns
+        // string i. Returns the index of the first invalid string or last.
+        //
+        template <typename View>
+        std::size_t convert_times(View view, std::size_t first,
+            std::size_t last, sys_time* times) noexcept
+        {
+            for (; first < last; ++first) {
+                const auto result = try_to_sys_time(view(first));
+                if (!result) {
+                    return first;
+                }
+                times[first] = result.value;
+            }
+            return last;
+        }
 
-            // parse year, month, and day
-            result = date::sys_days(date::year_month_day {
-                detail::to_year(tok.next('-')), detail::to_month(tok.next('-')),
-                detail::to_day(tok.next("T "))});
+#if defined(STUFF_AVX2_DISPATCH)
 
-            // parse hours, minutes, seconds, and nanoseconds
-            result += detail::to_hours(tok.next(':'));
-            result += detail::to_minutes(tok.next(':'));
-            result += detail::to_seconds(tok.next(".Z"));
-            result += detail::to_nanoseconds(tok.next('Z'));
+        //
+        // Parse "YYYY-MM-DDTHH:MM:SS.fffffffff" (or with ' ' for 'T') at p
+        // into the time since the epoch in one 256-bit register: characters
+        // [0, 16) in the low half and [13, 29) in the high half, so nothing
+        // past the string is read. Every character is checked against its
+        // position (a digit or a separator) at once, then the digits are
+        // gathered and multiplied into two-digit numbers.
+        //
+        STUFF_TARGET_AVX2 inline bool parse_fixed_avx2(
+            const char* p, duration& result) noexcept
+        {
+            const auto x = _mm256_inserti128_si256(
+                _mm256_castsi128_si256(
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(p))),
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 13)), 1);
+
+            // "DDDD-DD-DDTDD:DD" and ":DD:DD.DDDDDDDDD"
+            const auto digit_positions = _mm256_setr_epi8(-1, -1, -1, -1, 0,
+                -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1, 0, -1, -1,
+                0, -1, -1, -1, -1, -1, -1, -1, -1, -1);
+            const auto seps = _mm256_setr_epi8(0, 0, 0, 0, '-', 0, 0, '-', 0,
+                0, 'T', 0, 0, ':', 0, 0, ':', 0, 0, ':', 0, 0, '.', 0, 0, 0, 0,
+                0, 0, 0, 0, 0);
+            const auto alt_seps = _mm256_setr_epi8(0, 0, 0, 0, '-', 0, 0, '-',
+                0, 0, ' ', 0, 0, ':', 0, 0, ':', 0, 0, ':', 0, 0, '.', 0, 0, 0,
+                0, 0, 0, 0, 0, 0);
+
+            const auto d = _mm256_sub_epi8(x, _mm256_set1_epi8('0'));
+            const auto is_digit =
+                _mm256_cmpeq_epi8(_mm256_min_epu8(d, _mm256_set1_epi8(9)), d);
+            const auto is_sep = _mm256_or_si256(
+                _mm256_cmpeq_epi8(x, seps), _mm256_cmpeq_epi8(x, alt_seps));
+            if (_mm256_movemask_epi8(
+                    _mm256_blendv_epi8(is_sep, is_digit, digit_positions))
+                != -1) {
+                return false;
+            }
+
+            // YY YY MM DD HH MM -- -- | -- SS ff ff ff ff -- 0f
+            const auto gather = _mm256_setr_epi8(0, 1, 2, 3, 5, 6, 8, 9, 11,
+                12, 14, 15, -1, -1, -1, -1, -1, -1, 4, 5, 7, 8, 9, 10, 11, 12,
+                13, 14, -1, -1, -1, 15);
+            const auto pairs = _mm256_maddubs_epi16(
+                _mm256_shuffle_epi8(d, gather), _mm256_set1_epi16(0x010A));
+            alignas(32) std::uint16_t w[16];
+            _mm256_store_si256(reinterpret_cast<__m256i*>(w), pairs);
+
+            if (w[2] < 1 || w[2] > 12 || w[3] < 1 || w[3] > 31) {
+                return false;
+            }
+            const long ns =
+                (((w[10] * 100L + w[11]) * 100 + w[12]) * 100 + w[13]) * 10
+                + w[15];
+            return to_duration(w[0] * 100 + w[1], w[2], w[3],
+                w[4] * 3600L + w[5] * 60 + w[9], ns, result);
+        }
+
+        template <typename View>
+        STUFF_TARGET_AVX2 std::size_t convert_times_avx2(View view,
+            std::size_t first, std::size_t last, sys_time* times) noexcept
+        {
+            for (; first < last; ++first) {
+                const auto str   = view(first);
+                const auto n     = str.size();
+                const bool fixed = n == fixed_nanoseconds_size
+                                   || (n == fixed_nanoseconds_size + 1
+                                       && str.back() == 'Z');
+                duration since_epoch;
+                if (fixed && parse_fixed_avx2(str.data(), since_epoch)) {
+                    times[first] = sys_time {since_epoch};
+                    continue;
+                }
+
+                const auto result = try_to_sys_time(str);
+                if (!result) {
+                    return first;
+                }
+                times[first] = result.value;
+            }
+            return last;
+        }
+
+#endif
+
+        template <typename View>
+        std::size_t convert_range(View view, std::size_t first,
+            std::size_t last, sys_time* times) noexcept
+        {
+#if defined(STUFF_AVX2_DISPATCH)
+            // (a string is about 30 bytes, so 16 or more)
+            if (core::detail::use_avx2(last - first, 16)) {
+                return convert_times_avx2(view, first, last, times);
+            }
+#endif
+            return convert_times(view, first, last, times);
+        }
+
+        // fewer strings than this per thread are not worth the thread
+        constexpr std::size_t min_thread_size = 1 << 16;
+
+        //
+        // Convert strings [0, count) to times, split evenly across threads.
+        // Returns the index of the first invalid string or count.
+        //
+        template <typename View>
+        std::size_t convert_all(
+            View view, std::size_t count, sys_time* times, unsigned threads)
+        {
+            if (threads == 0) {
+                threads = std::max(1U, std::thread::hardware_concurrency());
+            }
+            threads = static_cast<unsigned>(std::min<std::size_t>(
+                threads, std::max<std::size_t>(1, count / min_thread_size)));
+            if (threads == 1) {
+                return convert_range(view, 0, count, times);
+            }
+
+            const auto chunk = (count + threads - 1) / threads;
+            auto       part  = [&](std::size_t first) {
+                const auto last = std::min(count, first + chunk);
+                const auto i    = convert_range(view, first, last, times);
+                return i == last ? count : i;
+            };
+
+            // this thread converts the first part
+            std::vector<std::future<std::size_t>> parts;
+            for (unsigned t = 1; t < threads; ++t) {
+                parts.push_back(std::async(
+                    std::launch::async, part, std::min(count, t * chunk)));
+            }
+            auto invalid = part(0);
+            for (auto& f : parts) {
+                invalid = std::min(invalid, f.get());
+            }
+            return invalid;
+        }
 
+    } // namespace
+
+    string::conversion_result<sys_time> try_to_sys_time(
+        std::string_view view) noexcept
+    {
+        string::conversion_result<sys_time> result;
+        duration                            since_epoch;
+        if (parse_fixed(view, true, since_epoch)) {
+            result.value = sys_time {since_epoch};
             return result;
         }
-        catch (const std::exception& e) {
-            STUFF_NESTED_THROW(datetime_error, "invalid date string: {}", view);
+
+        string::string_tokenizer tok {view};
+        std::int64_t             seconds;
+        duration                 ns;
+        if (parse_date_time(tok, ".Z", seconds)
+            && parse_nanoseconds(tok.next('Z'), ns)
+            && to_duration(seconds, ns.count(), since_epoch)) {
+            result.value = sys_time {since_epoch};
         }
+        else {
+            result.ec = std::errc::invalid_argument;
+        }
+        return result;
+    }
+
+    string::conversion_result<local_time> try_to_local_time(
+        std::string_view view) noexcept
+    {
+        string::conversion_result<local_time> result;
+        duration                              since_epoch;
+        if (parse_fixed(view, false, since_epoch)) {
+            result.value = local_time {since_epoch};
+            return result;
+        }
+
+        string::string_tokenizer tok {view};
+        std::int64_t             seconds;
+        duration                 ns;
+        if (parse_date_time(tok, ".", seconds)
+            && parse_nanoseconds(tok.tail(), ns)
+            && to_duration(seconds, ns.count(), since_epoch)) {
+            result.value = local_time {since_epoch};
+        }
+        else {
+            result.ec = std::errc::invalid_argument;
+        }
+        return result;
+    }
+
+    sys_time to_sys_time(std::string_view view)
+    {
+        auto result = try_to_sys_time(view);
+        STUFF_EXPECTS(result, datetime_error, "invalid date string: {}", view);
+        return result.value;
     }
 
     local_time to_local_time(std::string_view view)
     {
-        try {
-            local_time               result;
-            string::string_tokenizer tok {view};
+        auto result = try_to_local_time(view);
+        STUFF_EXPECTS(result, datetime_error, "invalid date string: {}", view);
+        return result.value;
+    }
 
-            // parse year, month, and day
-            result = date::local_days(date::year_month_day {
-                detail::to_year(tok.next('-')), detail::to_month(tok.next('-')),
-                detail::to_day(tok.next("T "))});
+    void to_sys_times(const std::string_view* views, std::size_t count,
+        sys_time* times, unsigned threads)
+    {
+        auto view = [views](std::size_t i) noexcept { return views[i]; };
+        auto i    = convert_all(view, count, times, threads);
+        STUFF_EXPECTS(
+            i == count, datetime_error, "invalid date string: {}", views[i]);
+    }
 
-            // parse hours, minutes, seconds, and nanoseconds
-            result += detail::to_hours(tok.next(':'));
-            result += detail::to_minutes(tok.next(':'));
-            result += detail::to_seconds(tok.next("."));
-            result += detail::to_nanoseconds(tok.tail());
+    std::vector<sys_time> to_sys_times(
+        const std::vector<std::string_view>& views, unsigned threads)
+    {
+        std::vector<sys_time> times(views.size());
+        to_sys_times(views.data(), views.size(), times.data(), threads);
+        return times;
+    }
 
-            return result;
-        }
-        catch (const std::exception& e) {
-            STUFF_NESTED_THROW(datetime_error, "invalid date string: {}", view);
-        }
+    void to_sys_times(const char* first, std::size_t size, std::size_t stride,
+        std::size_t count, sys_time* times, unsigned threads)
+    {
+        auto view = [first, size, stride](std::size_t i) noexcept {
+            return std::string_view {first + i * stride, size};
+        };
+        auto i = convert_all(view, count, times, threads);
+        STUFF_EXPECTS(
+            i == count, datetime_error, "invalid date string: {}", view(i));
     }
 
     sys_time to_sys_time(std::string_view local_view, time_zone local_tz)
     {
-        zoned_time zt = date::make_zoned(local_tz, to_local_time(local_view));
+        const auto local = to_local_time(local_view);
+        if (local_tz == nyc_tz()) {
+            // the times that happen twice or never throw below, as for others
+            if (auto sys = nyc_fast_zone().try_to_sys(local)) {
+                return *sys;
+            }
+        }
+        zoned_time zt = date::make_zoned(local_tz, local);
         return zt.get_sys_time();
     }
 
-    std::string to_string(sys_time t)
+    char* format_to(char* out, sys_time t) noexcept
+    {
+        out    = write_date_time(out, t.time_since_epoch());
+        *out++ = 'Z';
+        return out;
+    }
+
+    char* format_to(char* out, local_time t) noexcept
     {
-        // break into ymd and time-of-day
-        auto dp  = date::floor<date::days>(t);
-        auto ymd = date::year_month_day(dp);
-        auto tod = date::make_time(t - dp);
+        return write_date_time(out, t.time_since_epoch());
+    }
 
-        // format the string
-        return fmt::format(sys_fmt_str, static_cast<int>(ymd.year()),
-            static_cast<unsigned>(ymd.month()),
-            static_cast<unsigned>(ymd.day()), tod.hours().count(),
-            tod.minutes().count(), tod.seconds().count(),
-            tod.subseconds().count());
+    char* format_to(
+        char* out, const sys_time* times, std::size_t count) noexcept
+    {
+        time_converter converter;
+        for (std::size_t i = 0; i < count; ++i) {
+            out = converter.format_to(out, times[i]);
+        }
+        return out;
     }
 
-    std::string to_string(local_time t)
+    std::string to_string(sys_time t)
     {
-        // break into ymd and time-of-day
-        auto dp  = date::floor<date::days>(t);
-        auto ymd = date::year_month_day(dp);
-        auto tod = date::make_time(t - dp);
+        std::string str(sys_time_size, '\0');
+        format_to(str.data(), t);
+        return str;
+    }
 
-        // format the string
-        return fmt::format(local_fmt_str, static_cast<int>(ymd.year()),
-            static_cast<unsigned>(ymd.month()),
-            static_cast<unsigned>(ymd.day()), tod.hours().count(),
-            tod.minutes().count(), tod.seconds().count(),
-            tod.subseconds().count());
+    std::string to_string(local_time t)
+    {
+        std::string str(local_time_size, '\0');
+        format_to(str.data(), t);
+        return str;
     }
 
     std::string to_string(zoned_time t)
     {
-        // break into ymd and time-of-day
-        auto dp  = date::floor<date::days>(t.get_local_time());
-        auto ymd = date::year_month_day(dp);
-        auto tod = date::make_time(t.get_local_time() - dp);
-
-        // format the string
-        return fmt::format(zoned_fmt_str, static_cast<int>(ymd.year()),
-            static_cast<unsigned>(ymd.month()),
-            static_cast<unsigned>(ymd.day()), tod.hours().count(),
-            tod.minutes().count(), tod.seconds().count(),
-            tod.subseconds().count(), t.get_time_zone()->name());
+        const auto& name = t.get_time_zone()->name();
+
+        std::string str(local_time_size + 1 + name.size(), ' ');
+        format_to(str.data(), t.get_local_time());
+        name.copy(str.data() + local_time_size + 1, name.size());
+        return str;
+    }
+
+    sys_time time_converter::to_sys_time(std::string_view view)
+    {
+        auto result = try_to_sys_time(view);
+        STUFF_EXPECTS(result, datetime_error, "invalid date string: {}", view);
+        return result.value;
+    }
+
+    string::conversion_result<sys_time> time_converter::try_to_sys_time(
+        std::string_view view) noexcept
+    {
+        const auto n = fixed_size(view, true);
+        if (n == 0) {
+            return datetime::try_to_sys_time(view);
+        }
+
+        const char* p = view.data();
+        if (std::memcmp(p, m_parse_date.data(), fixed_date_size) != 0) {
+            std::int64_t days;
+            if (!parse_fixed_date(p, days)) {
+                return datetime::try_to_sys_time(view);
+            }
+            std::memcpy(m_parse_date.data(), p, fixed_date_size);
+            m_parse_days = days;
+        }
+
+        std::int64_t                        seconds;
+        std::int64_t                        ns;
+        string::conversion_result<sys_time> result;
+        duration                            since_epoch;
+        if (!parse_fixed_time(p, n, seconds, ns)
+            || !to_duration(m_parse_days * 86400 + seconds, ns, since_epoch)) {
+            return datetime::try_to_sys_time(view);
+        }
+        result.value = sys_time {since_epoch};
+        return result;
+    }
+
+    char* time_converter::format_to(char* out, sys_time t) noexcept
+    {
+        std::int64_t ns;
+        const auto   days = split_days(t.time_since_epoch(), ns);
+        if (days != m_format_days) {
+            write_date(m_format_date.data(), days);
+            m_format_days = days;
+        }
+
+        std::memcpy(out, m_format_date.data(), fixed_date_size);
+        out    = write_time_of_day(out + fixed_date_size, ns);
+        *out++ = 'Z';
+        return out;
+    }
+
+    std::string time_converter::to_string(sys_time t)
+    {
+        std::string str(sys_time_size, '\0');
+        format_to(str.data(), t);
+        return str;
     }
 
 } // namespace stuff::datetime
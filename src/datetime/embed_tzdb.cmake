@@ -0,0 +1,74 @@
+################################################################################
+# stuff_embed_tzdb(output dir zones)
+#
+# Write the C++ file output with the TZif files of zones (a list of time zone
+# names, or all) in dir (e.g., /usr/share/zoneinfo) as byte arrays, sorted by
+# name, for stuff::datetime::detail::embedded_zones(). The file is only
+# rewritten when its content changes.
+################################################################################
+function(stuff_embed_tzdb output dir zones)
+    if (zones STREQUAL "all")
+        file(GLOB_RECURSE files RELATIVE ${dir} ${dir}/*)
+        set(zones "")
+        foreach (file ${files})
+            # skip the copies with leap seconds (right) or without (posix)
+            if (file MATCHES "^(posix|right)/")
+                continue()
+            endif ()
+            file(READ ${dir}/${file} magic LIMIT 4 HEX)
+            if (magic STREQUAL "545a6966") # TZif
+                list(APPEND zones ${file})
+            endif ()
+        endforeach ()
+    endif ()
+    list(REMOVE_DUPLICATES zones)
+    list(SORT zones)
+    list(LENGTH zones count)
+    if (count EQUAL 0)
+        message(FATAL_ERROR "No time zones to embed from ${dir}")
+    endif ()
+    message(STATUS "Embedding ${count} time zones from ${dir}")
+
+    # 12 bytes a row (CMake regular expressions have no {12})
+    set(row "")
+    foreach (byte RANGE 1 12)
+        string(APPEND row "0x..,")
+    endforeach ()
+    set(row "(${row})")
+
+    set(arrays "")
+    set(entries "")
+    set(i 0)
+    foreach (zone ${zones})
+        if (NOT EXISTS ${dir}/${zone})
+            message(FATAL_ERROR "No TZif file for ${zone} in ${dir}")
+        endif ()
+        file(READ ${dir}/${zone} hex HEX)
+        string(REGEX REPLACE "(..)" "0x\\1," bytes "${hex}")
+        string(REGEX REPLACE "${row}" "\\1\n            " bytes "${bytes}")
+        string(APPEND arrays
+            "        const unsigned char zone_${i}[] {\n"
+            "            ${bytes}};\n\n")
+        string(APPEND entries
+            "            {\"${zone}\", zone_${i}, sizeof(zone_${i})},\n")
+        math(EXPR i "${i} + 1")
+    endforeach ()
+
+    file(WRITE ${output}.in
+        "// Generated by embed_tzdb.cmake from ${dir}. Do not edit.\n\n"
+        "#include <stuff/datetime/zone.h>\n\n"
+        "namespace stuff::datetime::detail {\n\n"
+        "    namespace {\n\n"
+        "${arrays}"
+        "        const embedded_zone zones[] {\n"
+        "${entries}"
+        "        };\n\n"
+        "    } // namespace\n\n"
+        "    std::pair<const embedded_zone*, std::size_t> embedded_zones() "
+        "noexcept\n"
+        "    {\n"
+        "        return {zones, sizeof(zones) / sizeof(zones[0])};\n"
+        "    }\n\n"
+        "} // namespace stuff::datetime::detail\n")
+    configure_file(${output}.in ${output} COPYONLY)
+endfunction()
@@ -15,22 +15,209 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
+#include <fmt/format.h>
+#include <fstream>
+#include <stuff/datetime/conversions.h>
 #include <stuff/datetime/datetime.h>
 #include <stuff/datetime/financial.h>
+#include <stuff/datetime/zone.h>
 
 namespace stuff::datetime {
 
+    namespace {
+
+        constexpr auto one_week = date::days {7};
+
+        // the forex closes at 5:00 PM in New York
+        constexpr auto bell_time = std::chrono::hours {17};
+
+        // trim trailing white space (and \r of Windows line ends)
+        std::string_view trim(std::string_view view) noexcept
+        {
+            while (!view.empty()
+                   && (view.back() == ' ' || view.back() == '\t'
+                       || view.back() == '\r')) {
+                view.remove_suffix(1);
+            }
+            return view;
+        }
+
+        // sort and merge closures that overlap
+        std::vector<forex_closure> merge(std::vector<forex_closure> closures)
+        {
+            std::sort(closures.begin(), closures.end(),
+                [](const auto& a, const auto& b) { return a.from < b.from; });
+
+            std::vector<forex_closure> merged;
+            for (const auto& closure : closures) {
+                if (!merged.empty() && closure.from <= merged.back().to) {
+                    merged.back().to = std::max(merged.back().to, closure.to);
+                    continue;
+                }
+                merged.push_back(closure);
+            }
+            return merged;
+        }
+
+    } // namespace
+
     forex_bells get_forex_bells(sys_time t) noexcept
     {
+        const auto& nyc = nyc_fast_zone();
+
         // find sunday in nyc
-        zoned_time sunday = find_sunday(date::make_zoned(nyc_tz(), t));
+        local_time sunday =
+            find_sunday(date::floor<date::days>(nyc.to_local(t)));
 
         // compute open and close in nyc
-        local_time open  = sunday.get_local_time() + std::chrono::hours(17);
+        local_time open  = sunday + std::chrono::hours(17);
         local_time close = open + date::days(5);
 
-        return forex_bells {date::make_zoned(nyc_tz(), open).get_sys_time(),
-            date::make_zoned(nyc_tz(), close).get_sys_time()};
+        return forex_bells {nyc.to_sys(open, local_policy::earliest),
+            nyc.to_sys(close, local_policy::earliest)};
+    }
+
+    std::vector<forex_closure> read_forex_closures(std::istream& in)
+    {
+        const auto& nyc = nyc_fast_zone();
+        const auto  to_sys = [&nyc](local_time t) {
+            return nyc.to_sys(t, local_policy::earliest);
+        };
+
+        std::vector<forex_closure> closures;
+        std::string                line;
+        for (std::size_t number = 1; std::getline(in, line); ++number) {
+            const auto view = trim(line);
+            if (view.empty() || view.front() == '#') {
+                continue;
+            }
+
+            try {
+                const auto space = view.find(' ');
+                if (space == std::string_view::npos) {
+                    const auto close =
+                        to_local_time(fmt::format("{}T17:00:00", view));
+                    closures.push_back(
+                        {to_sys(close - date::days {1}), to_sys(close)});
+                    continue;
+                }
+
+                auto to = view.substr(space);
+                to.remove_prefix(to.find_first_not_of(" \t"));
+                const forex_closure closure {
+                    to_sys(to_local_time(view.substr(0, space))),
+                    to_sys(to_local_time(to))};
+                STUFF_EXPECTS(closure.from < closure.to, datetime_error,
+                    "{} is not before {}", view.substr(0, space), to);
+                closures.push_back(closure);
+            }
+            catch (const datetime_error&) {
+                STUFF_NESTED_THROW(
+                    datetime_error, "bad forex closure on line {}", number);
+            }
+        }
+        STUFF_EXPECTS(!in.bad(), datetime_error, "failed to read closures");
+        return closures;
+    }
+
+    std::vector<forex_closure> read_forex_closures(const std::string& filename)
+    {
+        std::ifstream in {filename};
+        STUFF_EXPECTS(in.is_open(), datetime_error, "failed to open {}",
+            filename);
+        return read_forex_closures(in);
+    }
+
+    forex_calendar::forex_calendar(date::year first, date::year last,
+        std::vector<forex_closure> closures)
+    {
+        STUFF_EXPECTS(first <= last, datetime_error, "{} is after {}",
+            static_cast<int>(first), static_cast<int>(last));
+        const auto& nyc = nyc_fast_zone();
+
+        // whole weeks (in UTC), from a sunday before the first day to one
+        // after the last
+        const auto begin =
+            find_sunday(sys_days {first / date::January / 1}) - one_week;
+        const auto end =
+            find_sunday(sys_days {(last + date::years {1}) / 1 / 1})
+            + one_week * 2;
+
+        // the sessions of every week in the range (and a week more on each
+        // side since a session ends a day later in UTC), less the closures
+        std::vector<session> sessions;
+        const auto           merged = merge(std::move(closures));
+        auto                 c      = merged.begin();
+        for (auto sunday = local_days {begin.time_since_epoch()} - one_week;
+             sunday < local_days {end.time_since_epoch()} + one_week;
+             sunday += one_week) {
+            const auto open  = sunday + bell_time;
+            auto       from  = nyc.to_sys(open, local_policy::earliest);
+            const auto close =
+                nyc.to_sys(open + date::days {5}, local_policy::earliest);
+
+            while (c != merged.end() && c->to <= from) {
+                ++c;
+            }
+            for (auto d = c; d != merged.end() && d->from < close; ++d) {
+                if (from < d->from) {
+                    sessions.push_back({from, d->from});
+                }
+                from = std::max(from, d->to);
+            }
+            if (from < close) {
+                sessions.push_back({from, close});
+            }
+        }
+
+        m_table = detail::session_table {begin, end, std::move(sessions)};
+    }
+
+    bool forex_calendar::is_open(sys_time t) const noexcept
+    {
+        if (!m_table.in_range(t)) {
+            const auto bells = get_forex_bells(t);
+            return t >= bells.open && t < bells.close;
+        }
+        return m_table.is_open(t);
+    }
+
+    std::optional<forex_bells> forex_calendar::session_of(
+        sys_time t) const noexcept
+    {
+        if (!m_table.in_range(t)) {
+            const auto bells = get_forex_bells(t);
+            if (t >= bells.open && t < bells.close) {
+                return bells;
+            }
+            return std::nullopt;
+        }
+
+        const auto s = m_table.session_of(t);
+        if (!s) {
+            return std::nullopt;
+        }
+        return forex_bells {s->open, s->close};
+    }
+
+    void forex_calendar::classify(
+        const sys_time* times, std::size_t count, bool* open) const noexcept
+    {
+        m_table.classify(times, count, [&](std::size_t k, bool is) noexcept {
+            open[k] = m_table.in_range(times[k]) ? is : is_open(times[k]);
+        });
+    }
+
+    std::vector<bool> forex_calendar::classify(
+        const std::vector<sys_time>& times) const
+    {
+        std::vector<bool> open(times.size());
+        m_table.classify(times.data(), times.size(),
+            [&](std::size_t k, bool is) {
+                open[k] = m_table.in_range(times[k]) ? is : is_open(times[k]);
+            });
+        return open;
     }
 
 } // namespace stuff::datetime
@@ -0,0 +1,612 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <array>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <stuff/datetime/datetime.h>
+#include <stuff/datetime/zone.h>
+
+namespace stuff::datetime {
+
+    namespace {
+
+        using std::chrono::seconds;
+
+        constexpr auto one_day = std::chrono::hours {24};
+
+        // the index of the day of t since begin
+        template <typename T>
+        inline std::size_t day_index(T t, T begin) noexcept
+        {
+            return static_cast<std::size_t>((t - begin) / one_day);
+        }
+
+        // when the offset changes to offset
+        struct change {
+            date::sys_seconds begin;
+            seconds           offset;
+        };
+
+        // the data of a TZif file (RFC 8536)
+        struct tzif_data {
+            seconds             initial; // the offset before the first change
+            std::vector<change> changes;
+            std::string_view    footer; // a POSIX TZ string for later times
+        };
+
+        // read a big-endian, two's complement integer of size bytes
+        std::int64_t read_int(const char* p, std::size_t size) noexcept
+        {
+            std::uint64_t x = 0;
+            for (std::size_t i = 0; i < size; ++i) {
+                x = (x << 8) | static_cast<unsigned char>(p[i]);
+            }
+            const auto bits = size * 8;
+            if (bits < 64 && ((x >> (bits - 1)) & 1) != 0) {
+                x |= ~std::uint64_t {0} << bits;
+            }
+            return static_cast<std::int64_t>(x);
+        }
+
+        tzif_data read_tzif(std::string_view name, std::string_view tzif)
+        {
+            constexpr std::size_t header_size = 44;
+
+            const auto expects = [&](bool ok) {
+                STUFF_EXPECTS(ok, datetime_error, "bad TZif file for {}", name);
+            };
+            const auto count = [&](std::size_t pos, std::size_t i) {
+                return static_cast<std::size_t>(
+                    read_int(tzif.data() + pos + 20 + i * 4, 4));
+            };
+
+            // the version 1 data (32 bit times) is followed by the same with
+            // 64 bit times and a footer in version 2 and later
+            expects(tzif.size() >= header_size && tzif.substr(0, 4) == "TZif");
+            const bool  v2        = tzif[4] >= '2';
+            std::size_t pos       = 0;
+            std::size_t time_size = 4;
+            auto        block     = [&](std::size_t size) {
+                return count(pos, 3) * (size + 1) + count(pos, 4) * 6
+                       + count(pos, 5) + count(pos, 2) * (size + 4)
+                       + count(pos, 1) + count(pos, 0);
+            };
+            if (v2) {
+                pos       = header_size + block(4);
+                time_size = 8;
+                expects(tzif.size() >= pos + header_size
+                        && tzif.substr(pos, 4) == "TZif");
+            }
+
+            const auto times = count(pos, 3);
+            const auto types = count(pos, 4);
+            const auto end   = pos + header_size + block(time_size);
+            expects(types > 0 && tzif.size() >= end);
+
+            const char* p       = tzif.data() + pos + header_size;
+            const char* indexes = p + times * time_size;
+            const char* offsets = indexes + times;
+
+            tzif_data data;
+            data.initial = seconds {read_int(offsets, 4)};
+            data.changes.reserve(times);
+            for (std::size_t i = 0; i < times; ++i) {
+                const auto type = static_cast<unsigned char>(indexes[i]);
+                expects(type < types);
+                data.changes.push_back(
+                    {date::sys_seconds {seconds {
+                         read_int(p + i * time_size, time_size)}},
+                        seconds {read_int(offsets + type * 6, 4)}});
+            }
+
+            if (v2 && end < tzif.size() && tzif[end] == '\n') {
+                const auto footer = tzif.substr(end + 1);
+                data.footer       = footer.substr(0, footer.find('\n'));
+            }
+            return data;
+        }
+
+        //
+        // A POSIX TZ string, e.g., "EST5EDT,M3.2.0,M11.1.0" (New York is 5
+        // hours behind UTC, 4 in daylight saving time, which starts on the
+        // second Sunday in March and ends on the first in November, at 2am).
+        //
+        class posix_tz {
+        public:
+            posix_tz(std::string_view name, std::string_view tz)
+            : m_name {name}
+            , m_tz {tz}
+            {
+                skip_name();
+                m_std = -read_time();
+                if (m_tz.empty()) {
+                    m_dst = m_std;
+                    return;
+                }
+
+                skip_name();
+                // an hour ahead unless it says otherwise
+                m_dst = m_std + std::chrono::hours {1};
+                if (!m_tz.empty() && m_tz.front() != ',') {
+                    m_dst = -read_time();
+                }
+                expects(read(','));
+                m_start = read_rule();
+                expects(read(','));
+                m_end = read_rule();
+                expects(m_tz.empty());
+            }
+
+            // the changes in year y (in the order they happen)
+            [[nodiscard]] std::array<change, 2> changes(date::year y) const
+            {
+                std::array<change, 2> both {
+                    change {at(m_start, y, m_std), m_dst},
+                    change {at(m_end, y, m_dst), m_std}};
+                if (both[1].begin < both[0].begin) {
+                    std::swap(both[0], both[1]);
+                }
+                return both;
+            }
+
+            [[nodiscard]] seconds std_offset() const noexcept { return m_std; }
+
+            [[nodiscard]] bool has_dst() const noexcept
+            {
+                return m_dst != m_std;
+            }
+
+        private:
+            // a day of the year (Jn, n or Mm.w.d) and a local time
+            struct rule {
+                char    kind;
+                int     month;
+                int     week;
+                int     day;
+                seconds time;
+            };
+
+            void expects(bool ok) const
+            {
+                STUFF_EXPECTS(ok, datetime_error,
+                    "unsupported POSIX TZ string for {}", m_name);
+            }
+
+            bool read(char c) noexcept
+            {
+                if (m_tz.empty() || m_tz.front() != c) {
+                    return false;
+                }
+                m_tz.remove_prefix(1);
+                return true;
+            }
+
+            // e.g., "EST" or "<+03>"
+            void skip_name()
+            {
+                std::size_t n = 0;
+                if (read('<')) {
+                    n = m_tz.find('>');
+                    expects(n != std::string_view::npos);
+                    m_tz.remove_prefix(n + 1);
+                    return;
+                }
+                while (n < m_tz.size()
+                       && ((m_tz[n] >= 'A' && m_tz[n] <= 'Z')
+                           || (m_tz[n] >= 'a' && m_tz[n] <= 'z'))) {
+                    ++n;
+                }
+                expects(n > 0);
+                m_tz.remove_prefix(n);
+            }
+
+            int read_number()
+            {
+                const auto digit = [this]() noexcept {
+                    return !m_tz.empty() && m_tz.front() >= '0'
+                           && m_tz.front() <= '9';
+                };
+                expects(digit());
+                int n = 0;
+                while (digit()) {
+                    n = n * 10 + (m_tz.front() - '0');
+                    m_tz.remove_prefix(1);
+                    expects(n < 10000);
+                }
+                return n;
+            }
+
+            // [+-]hh[:mm[:ss]]
+            seconds read_time()
+            {
+                const bool negative = read('-');
+                if (!negative) {
+                    read('+');
+                }
+                seconds time = std::chrono::hours {read_number()};
+                if (read(':')) {
+                    time += std::chrono::minutes {read_number()};
+                    if (read(':')) {
+                        time += seconds {read_number()};
+                    }
+                }
+                return negative ? -time : time;
+            }
+
+            rule read_rule()
+            {
+                rule r {'n', 0, 0, 0, std::chrono::hours {2}};
+                if (read('M')) {
+                    r.kind  = 'M';
+                    r.month = read_number();
+                    expects(read('.'));
+                    r.week = read_number();
+                    expects(read('.'));
+                    r.day = read_number();
+                    expects(r.month >= 1 && r.month <= 12 && r.week >= 1
+                            && r.week <= 5 && r.day <= 6);
+                }
+                else {
+                    r.kind = read('J') ? 'J' : 'n';
+                    r.day  = read_number();
+                    expects(r.day <= 365);
+                }
+                if (read('/')) {
+                    r.time = read_time();
+                }
+                return r;
+            }
+
+            // when r happens in year y while offset is in effect
+            static date::sys_seconds at(
+                const rule& r, date::year y, seconds offset) noexcept
+            {
+                local_days day;
+                if (r.kind == 'M') {
+                    const auto ym = y / date::month {unsigned(r.month)};
+                    const auto wd = date::weekday {unsigned(r.day)};
+                    day = r.week == 5 ? local_days {ym / wd[date::last]}
+                                      : local_days {ym / wd[unsigned(r.week)]};
+                }
+                else {
+                    // Jn counts from 1 and never counts February 29
+                    day = local_days {y / date::January / 1}
+                          + date::days {r.day};
+                    if (r.kind == 'J') {
+                        const bool leap_day = r.day >= 60 && y.is_leap();
+                        day -= date::days {leap_day ? 0 : 1};
+                    }
+                }
+                return date::sys_seconds {
+                    (day + r.time).time_since_epoch() - offset};
+            }
+
+            std::string_view m_name;
+            std::string_view m_tz;
+            seconds          m_std {0};
+            seconds          m_dst {0};
+            rule             m_start {};
+            rule             m_end {};
+
+        }; // class posix_tz
+
+        fast_zone make_fast_zone(std::string_view name)
+        {
+            constexpr date::year first {1970};
+            constexpr date::year last {2069};
+
+            const auto [zones, size] = detail::embedded_zones();
+            const auto zone          = std::lower_bound(zones, zones + size,
+                name, [](const detail::embedded_zone& z, std::string_view n) {
+                    return std::string_view {z.name} < n;
+                });
+            if (zone != zones + size && zone->name == name) {
+                return fast_zone {std::string {name},
+                    std::string_view {
+                        reinterpret_cast<const char*>(zone->data), zone->size},
+                    first, last};
+            }
+
+            time_zone tz = nullptr;
+            try {
+                tz = date::locate_zone(std::string {name});
+            }
+            catch (const std::runtime_error&) {
+                // not in the database
+            }
+            STUFF_EXPECTS(
+                tz != nullptr, datetime_error, "unknown time zone {}", name);
+            return fast_zone {tz, first, last};
+        }
+
+    } // namespace
+
+#if !defined(STUFF_DATETIME_EMBEDDED_TZDB)
+
+    namespace detail {
+
+        std::pair<const embedded_zone*, std::size_t> embedded_zones() noexcept
+        {
+            return {nullptr, 0};
+        }
+
+    } // namespace detail
+
+#endif
+
+    fast_zone::fast_zone(time_zone tz, date::year first, date::year last)
+    : m_tz {tz}
+    {
+        STUFF_EXPECTS(tz != nullptr, datetime_error, "no time zone");
+        m_name = tz->name();
+        set_range(first, last);
+
+        // the transitions in effect in [m_begin, m_end); compare in seconds
+        // since the first and last may be "forever" (e.g., for UTC)
+        const auto end  = date::floor<seconds>(m_end);
+        auto       info = m_tz->get_info(m_begin);
+        add(m_begin, info.offset);
+        while (info.end < end) {
+            info = m_tz->get_info(info.end);
+            add(sys_time {info.begin}, info.offset);
+        }
+        index();
+    }
+
+    fast_zone::fast_zone(std::string name, std::string_view tzif,
+        date::year first, date::year last)
+    : m_name {std::move(name)}
+    {
+        set_range(first, last);
+        auto data = read_tzif(m_name, tzif);
+
+        // the footer gives the changes after the last in the file
+        if (!data.footer.empty()) {
+            const posix_tz tz {m_name, data.footer};
+            auto           after = date::sys_seconds::min();
+            auto           y     = first - date::years {1};
+            if (data.changes.empty()) {
+                data.initial = tz.std_offset();
+            }
+            else {
+                after = data.changes.back().begin;
+                y     = std::max(y,
+                    date::year_month_day {date::floor<date::days>(after)}
+                        .year());
+            }
+            for (; tz.has_dst() && y <= last + date::years {1}; ++y) {
+                for (const auto& c : tz.changes(y)) {
+                    if (c.begin > after) {
+                        data.changes.push_back(c);
+                    }
+                }
+            }
+        }
+
+        // the offset in effect at m_begin, then the changes until m_end (in
+        // seconds since a TZif file may start at the "big bang")
+        const auto begin  = date::floor<seconds>(m_begin);
+        const auto end    = date::floor<seconds>(m_end);
+        auto       c      = data.changes.begin();
+        auto       offset = data.initial;
+        for (; c != data.changes.end() && c->begin <= begin; ++c) {
+            offset = c->offset;
+        }
+        add(m_begin, offset);
+        for (; c != data.changes.end() && c->begin < end; ++c) {
+            add(sys_time {c->begin}, c->offset);
+        }
+        index();
+    }
+
+    time_zone fast_zone::zone() const
+    {
+        return m_tz != nullptr ? m_tz : date::locate_zone(m_name);
+    }
+
+    void fast_zone::set_range(date::year first, date::year last)
+    {
+        STUFF_EXPECTS(first <= last, datetime_error, "{} is after {}",
+            static_cast<int>(first), static_cast<int>(last));
+
+        // a day more on each side: local times of the first and last days
+        // are then in the range, whatever the offset
+        m_begin = sys_days {first / date::January / 1} - date::days {1};
+        m_end   = sys_days {(last + date::years {1}) / date::January / 1}
+                + date::days {1};
+    }
+
+    void fast_zone::add(sys_time begin, seconds offset)
+    {
+        if (m_transitions.empty()) {
+            const local_time here {begin.time_since_epoch() + offset};
+            m_transitions.push_back({begin, offset, here, here});
+            return;
+        }
+
+        const auto prev = m_transitions.back().offset;
+        if (offset == prev) {
+            return;
+        }
+        const auto low  = std::min(prev, offset);
+        const auto high = std::max(prev, offset);
+        m_transitions.push_back({begin, offset,
+            local_time {begin.time_since_epoch() + low},
+            local_time {begin.time_since_epoch() + high}});
+    }
+
+    void fast_zone::index()
+    {
+        STUFF_EXPECTS(
+            m_transitions.size() < std::numeric_limits<std::uint32_t>::max(),
+            datetime_error, "too many transitions in {}", m_name);
+
+        // the transition in effect at the start of every day (in UTC and in
+        // local time)
+        const auto  days = day_index(m_end, m_begin);
+        std::size_t i    = 0;
+        std::size_t j    = 0;
+        m_sys_days.reserve(days);
+        m_local_days.reserve(days);
+        for (std::size_t d = 0; d < days; ++d) {
+            const auto sys_midnight =
+                m_begin + date::days {static_cast<int>(d)};
+            while (i + 1 < m_transitions.size()
+                   && m_transitions[i + 1].begin <= sys_midnight) {
+                ++i;
+            }
+            m_sys_days.push_back(static_cast<std::uint32_t>(i));
+
+            const local_time local_midnight {sys_midnight.time_since_epoch()};
+            while (j + 1 < m_transitions.size()
+                   && m_transitions[j + 1].local_begin <= local_midnight) {
+                ++j;
+            }
+            m_local_days.push_back(static_cast<std::uint32_t>(j));
+        }
+    }
+
+    bool fast_zone::in_range(sys_time t) const noexcept
+    {
+        return t >= m_begin && t < m_end;
+    }
+
+    bool fast_zone::in_range(local_time t) const noexcept
+    {
+        // a day inside, so that the sys time is in the range too
+        const auto since_epoch = t.time_since_epoch();
+        return since_epoch >= m_begin.time_since_epoch() + one_day
+               && since_epoch < m_end.time_since_epoch() - one_day;
+    }
+
+    std::size_t fast_zone::find(sys_time t) const noexcept
+    {
+        auto i = m_sys_days[day_index(t, m_begin)];
+        while (i + 1 < m_transitions.size()
+               && m_transitions[i + 1].begin <= t) {
+            ++i;
+        }
+        return i;
+    }
+
+    std::size_t fast_zone::find(local_time t) const noexcept
+    {
+        auto i = m_local_days[day_index(
+            t.time_since_epoch(), m_begin.time_since_epoch())];
+        while (i + 1 < m_transitions.size()
+               && m_transitions[i + 1].local_begin <= t) {
+            ++i;
+        }
+        return i;
+    }
+
+    std::chrono::seconds fast_zone::offset(sys_time t) const
+    {
+        if (!in_range(t)) {
+            return zone()->get_info(t).offset;
+        }
+        return m_transitions[find(t)].offset;
+    }
+
+    local_time fast_zone::to_local(sys_time t) const
+    {
+        return local_time {t.time_since_epoch() + offset(t)};
+    }
+
+    fast_zone::local_result fast_zone::resolve(local_time t) const
+    {
+        const auto since_epoch = t.time_since_epoch();
+        if (!in_range(t)) {
+            const auto info = zone()->get_info(t);
+            if (info.result == date::local_info::nonexistent) {
+                const sys_time end {info.first.end};
+                return {local_result::nonexistent, end, end};
+            }
+            if (info.result == date::local_info::ambiguous) {
+                return {local_result::ambiguous,
+                    sys_time {since_epoch - info.first.offset},
+                    sys_time {since_epoch - info.second.offset}};
+            }
+            const sys_time sys {since_epoch - info.first.offset};
+            return {local_result::unique, sys, sys};
+        }
+
+        const auto  i  = find(t);
+        const auto& tr = m_transitions[i];
+        if (t >= tr.local_end) {
+            const sys_time sys {since_epoch - tr.offset};
+            return {local_result::unique, sys, sys};
+        }
+
+        // the clocks went back (twice) or forward (never) at tr.begin; the
+        // first transition has no such local times, so i > 0
+        const auto prev = m_transitions[i - 1].offset;
+        if (tr.offset < prev) {
+            return {local_result::ambiguous, sys_time {since_epoch - prev},
+                sys_time {since_epoch - tr.offset}};
+        }
+        return {local_result::nonexistent, tr.begin, tr.begin};
+    }
+
+    sys_time fast_zone::to_sys(local_time t, local_policy policy) const
+    {
+        const auto result = resolve(t);
+        if (result.kind != local_result::unique
+            && policy == local_policy::error) {
+            STUFF_THROW(datetime_error, "{} is {} in {}", to_string(t),
+                result.kind == local_result::ambiguous ? "ambiguous"
+                                                       : "nonexistent",
+                m_name);
+        }
+        return policy == local_policy::latest ? result.latest
+                                              : result.earliest;
+    }
+
+    std::optional<sys_time> fast_zone::try_to_sys(local_time t) const
+    {
+        const auto result = resolve(t);
+        if (result.kind != local_result::unique) {
+            return std::nullopt;
+        }
+        return result.earliest;
+    }
+
+    const fast_zone& locate_fast_zone(std::string_view name)
+    {
+        static std::mutex                                    mutex;
+        static std::map<std::string, fast_zone, std::less<>> zones;
+
+        const std::lock_guard<std::mutex> lock {mutex};
+        auto                              zone = zones.find(name);
+        if (zone == zones.end()) {
+            zone =
+                zones.emplace(std::string {name}, make_fast_zone(name)).first;
+        }
+        return zone->second;
+    }
+
+    const fast_zone& nyc_fast_zone()
+    {
+        static const fast_zone& zone = locate_fast_zone("America/New_York");
+        return zone;
+    }
+
+} // namespace stuff::datetime
@@ -0,0 +1,398 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <cstddef>
+#include <stuff/core/cpu.h>
+#include <stuff/string/ascii.h>
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
+namespace stuff::string {
+
+    namespace {
+
+        //
+        // Each kernel works on [p, p + n). The scalar kernels finish what the
+        // vector kernels leave over (i.e., fewer than 16 or 32 characters).
+        //
+
+        // true if c is in [lo, lo + count] (i.e., one unsigned comparison)
+        constexpr bool in_range(char c, char lo, unsigned count) noexcept
+        {
+            return static_cast<unsigned char>(c - lo) <= count;
+        }
+
+        constexpr bool is_space(char c) noexcept
+        {
+            return c == ' ' || in_range(c, '\t', 4);
+        }
+
+        constexpr bool is_class(char c, char_class cls) noexcept
+        {
+            switch (cls) {
+                case char_class::digit:
+                    return in_range(c, '0', 9);
+                case char_class::alpha:
+                    return in_range(c | 0x20, 'a', 25);
+                case char_class::alnum:
+                    return in_range(c, '0', 9) || in_range(c | 0x20, 'a', 25);
+                case char_class::space:
+                    return is_space(c);
+            }
+            return false;
+        }
+
+        std::size_t first_not_space_scalar(
+            const char* p, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+            while (i < n && is_space(p[i])) {
+                ++i;
+            }
+            return i;
+        }
+
+        // return the length of [p, p + n) without trailing whitespace
+        std::size_t last_not_space_scalar(
+            const char* p, std::size_t n) noexcept
+        {
+            while (n > 0 && is_space(p[n - 1])) {
+                --n;
+            }
+            return n;
+        }
+
+        // flip the case of every character in [lo, lo + 25]
+        void fold_scalar(char* p, std::size_t n, char lo) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i) {
+                if (in_range(p[i], lo, 25)) {
+                    p[i] ^= 0x20;
+                }
+            }
+        }
+
+        bool all_of_scalar(
+            const char* p, std::size_t n, char_class cls) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i) {
+                if (!is_class(p[i], cls)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+#if defined(__SSE2__)
+
+        //
+        // SSE2 (16 characters at once) is the baseline of x86-64.
+        //
+
+        inline __m128i in_range_sse2(__m128i x, char lo, char count) noexcept
+        {
+            const auto t = _mm_sub_epi8(x, _mm_set1_epi8(lo));
+            return _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8(count)), t);
+        }
+
+        inline __m128i space_sse2(__m128i x) noexcept
+        {
+            return _mm_or_si128(_mm_cmpeq_epi8(x, _mm_set1_epi8(' ')),
+                in_range_sse2(x, '\t', 4));
+        }
+
+        inline __m128i class_sse2(__m128i x, char_class cls) noexcept
+        {
+            const auto folded = _mm_or_si128(x, _mm_set1_epi8(0x20));
+            switch (cls) {
+                case char_class::digit:
+                    return in_range_sse2(x, '0', 9);
+                case char_class::alpha:
+                    return in_range_sse2(folded, 'a', 25);
+                case char_class::alnum:
+                    return _mm_or_si128(in_range_sse2(x, '0', 9),
+                        in_range_sse2(folded, 'a', 25));
+                case char_class::space:
+                    break;
+            }
+            return space_sse2(x);
+        }
+
+        inline __m128i load_sse2(const char* p) noexcept
+        {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        }
+
+        std::size_t first_not_space_sse2(
+            const char* p, std::size_t n) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                auto mask = ~static_cast<unsigned>(_mm_movemask_epi8(
+                                space_sse2(load_sse2(p + i))))
+                            & 0xFFFFu;
+                if (mask != 0) {
+                    return i + static_cast<std::size_t>(__builtin_ctz(mask));
+                }
+            }
+            return i + first_not_space_scalar(p + i, n - i);
+        }
+
+        std::size_t last_not_space_sse2(
+            const char* p, std::size_t n) noexcept
+        {
+            for (; n >= 16; n -= 16) {
+                auto mask = ~static_cast<unsigned>(_mm_movemask_epi8(
+                                space_sse2(load_sse2(p + n - 16))))
+                            & 0xFFFFu;
+                if (mask != 0) {
+                    return n - 16 + 32
+                           - static_cast<std::size_t>(__builtin_clz(mask));
+                }
+            }
+            return last_not_space_scalar(p, n);
+        }
+
+        void fold_sse2(char* p, std::size_t n, char lo) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                const auto x    = load_sse2(p + i);
+                const auto flip = _mm_and_si128(
+                    in_range_sse2(x, lo, 25), _mm_set1_epi8(0x20));
+                _mm_storeu_si128(
+                    reinterpret_cast<__m128i*>(p + i), _mm_xor_si128(x, flip));
+            }
+            fold_scalar(p + i, n - i, lo);
+        }
+
+        bool all_of_sse2(
+            const char* p, std::size_t n, char_class cls) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 16 <= n; i += 16) {
+                if (_mm_movemask_epi8(class_sse2(load_sse2(p + i), cls))
+                    != 0xFFFF) {
+                    return false;
+                }
+            }
+            return all_of_scalar(p + i, n - i, cls);
+        }
+
+        // without AVX2, these are the best available
+    #define STUFF_STRING_BASELINE(name) name##_sse2
+#else
+    #define STUFF_STRING_BASELINE(name) name##_scalar
+#endif
+
+#if defined(STUFF_AVX2_DISPATCH)
+
+        //
+        // AVX2 (32 characters at once) if the CPU supports it.
+        //
+
+        STUFF_TARGET_AVX2 inline __m256i in_range_avx2(
+            __m256i x, char lo, char count) noexcept
+        {
+            const auto t = _mm256_sub_epi8(x, _mm256_set1_epi8(lo));
+            return _mm256_cmpeq_epi8(
+                _mm256_min_epu8(t, _mm256_set1_epi8(count)), t);
+        }
+
+        STUFF_TARGET_AVX2 inline __m256i space_avx2(__m256i x) noexcept
+        {
+            return _mm256_or_si256(_mm256_cmpeq_epi8(x, _mm256_set1_epi8(' ')),
+                in_range_avx2(x, '\t', 4));
+        }
+
+        STUFF_TARGET_AVX2 inline __m256i class_avx2(
+            __m256i x, char_class cls) noexcept
+        {
+            const auto folded = _mm256_or_si256(x, _mm256_set1_epi8(0x20));
+            switch (cls) {
+                case char_class::digit:
+                    return in_range_avx2(x, '0', 9);
+                case char_class::alpha:
+                    return in_range_avx2(folded, 'a', 25);
+                case char_class::alnum:
+                    return _mm256_or_si256(in_range_avx2(x, '0', 9),
+                        in_range_avx2(folded, 'a', 25));
+                case char_class::space:
+                    break;
+            }
+            return space_avx2(x);
+        }
+
+        STUFF_TARGET_AVX2 inline __m256i load_avx2(const char* p) noexcept
+        {
+            return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        }
+
+        //
+        // These are only called for 32 or more characters and finish with a
+        // last block that overlaps the one before it. Calling the SSE2
+        // kernels for the remainder instead would mix VEX and legacy SSE
+        // instructions (i.e., a transition penalty on many CPUs).
+        //
+
+        STUFF_TARGET_AVX2 std::size_t first_not_space_avx2(
+            const char* p, std::size_t n) noexcept
+        {
+            for (std::size_t i = 0;; i += 32) {
+                // the last block overlaps characters that are all whitespace
+                i         = std::min(i, n - 32);
+                auto mask = ~static_cast<unsigned>(
+                    _mm256_movemask_epi8(space_avx2(load_avx2(p + i))));
+                if (mask != 0) {
+                    return i + static_cast<std::size_t>(__builtin_ctz(mask));
+                }
+                if (i + 32 == n) {
+                    return n;
+                }
+            }
+        }
+
+        STUFF_TARGET_AVX2 std::size_t last_not_space_avx2(
+            const char* p, std::size_t n) noexcept
+        {
+            for (std::size_t end = n;; end -= 32) {
+                end       = std::max<std::size_t>(end, 32);
+                auto mask = ~static_cast<unsigned>(
+                    _mm256_movemask_epi8(space_avx2(load_avx2(p + end - 32))));
+                if (mask != 0) {
+                    return end - static_cast<std::size_t>(__builtin_clz(mask));
+                }
+                if (end == 32) {
+                    return 0;
+                }
+            }
+        }
+
+        STUFF_TARGET_AVX2 void fold_avx2(
+            char* p, std::size_t n, char lo) noexcept
+        {
+            const auto case_bit = _mm256_set1_epi8(0x20);
+
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                const auto x    = load_avx2(p + i);
+                const auto flip = _mm256_and_si256(in_range_avx2(x, lo, 25),
+                    case_bit);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + i),
+                    _mm256_xor_si256(x, flip));
+            }
+            if (i == n) {
+                return;
+            }
+
+            // only flip the characters that were not in the last block
+            const auto lanes = _mm256_setr_epi8(0, 1, 2, 3, 4, 5, 6, 7, 8, 9,
+                10, 11, 12, 13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25,
+                26, 27, 28, 29, 30, 31);
+            const auto fresh = _mm256_cmpgt_epi8(lanes,
+                _mm256_set1_epi8(static_cast<char>(31 - (n - i))));
+            const auto x     = load_avx2(p + n - 32);
+            const auto flip  = _mm256_and_si256(
+                _mm256_and_si256(in_range_avx2(x, lo, 25), fresh), case_bit);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(p + n - 32),
+                _mm256_xor_si256(x, flip));
+        }
+
+        STUFF_TARGET_AVX2 bool all_of_avx2(
+            const char* p, std::size_t n, char_class cls) noexcept
+        {
+            for (std::size_t i = 0; i < n; i += 32) {
+                // the last block overlaps characters that are in the class
+                const auto block = load_avx2(p + std::min(i, n - 32));
+                if (_mm256_movemask_epi8(class_avx2(block, cls)) != -1) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+#endif
+
+        //
+        // The kernel for n characters: AVX2 for 32 or more if the CPU has it
+        // (fewer always use the baseline; AVX2 would not pay for itself).
+        //
+        constexpr std::size_t min_avx2_size = 32;
+
+#if defined(STUFF_AVX2_DISPATCH)
+    #define STUFF_STRING_KERNEL(name, n) \
+        (core::detail::use_avx2(n, min_avx2_size) \
+                ? name##_avx2 \
+                : STUFF_STRING_BASELINE(name))
+#else
+    #define STUFF_STRING_KERNEL(name, n) STUFF_STRING_BASELINE(name)
+#endif
+
+        void fold(char* first, char* last, char lo) noexcept
+        {
+            const auto n = static_cast<std::size_t>(last - first);
+            STUFF_STRING_KERNEL(fold, n)(first, n, lo);
+        }
+
+    } // namespace
+
+    std::string_view ltrim(std::string_view view) noexcept
+    {
+        // most fields have no whitespace at all
+        if (view.empty() || !is_space(view.front())) {
+            return view;
+        }
+        view.remove_prefix(STUFF_STRING_KERNEL(first_not_space, view.size())(
+            view.data(), view.size()));
+        return view;
+    }
+
+    std::string_view rtrim(std::string_view view) noexcept
+    {
+        if (view.empty() || !is_space(view.back())) {
+            return view;
+        }
+        return view.substr(0,
+            STUFF_STRING_KERNEL(last_not_space, view.size())(
+                view.data(), view.size()));
+    }
+
+    std::string_view trim(std::string_view view) noexcept
+    {
+        return rtrim(ltrim(view));
+    }
+
+    void to_upper_ascii(char* first, char* last) noexcept
+    {
+        fold(first, last, 'a');
+    }
+
+    void to_lower_ascii(char* first, char* last) noexcept
+    {
+        fold(first, last, 'A');
+    }
+
+    bool all_of_class(std::string_view view, char_class cls) noexcept
+    {
+        return STUFF_STRING_KERNEL(all_of, view.size())(
+            view.data(), view.size(), cls);
+    }
+
+} // namespace stuff::string
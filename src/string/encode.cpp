@@ -0,0 +1,413 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stuff/core/cpu.h>
+#include <stuff/string/encode.h>
+
+namespace stuff::string {
+
+    namespace {
+
+        constexpr char hex_digits[] {"0123456789abcdef"};
+        constexpr char base64_digits[] {
+            "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+
+        // character -> value or -1 if invalid
+        constexpr std::array<std::int8_t, 256> make_values(
+            const char* digits, std::size_t count, bool any_case)
+        {
+            std::array<std::int8_t, 256> values {};
+            for (auto& value : values) {
+                value = -1;
+            }
+            for (std::size_t i = 0; i < count; ++i) {
+                const auto c = static_cast<unsigned char>(digits[i]);
+                values[c]    = static_cast<std::int8_t>(i);
+                if (any_case && c >= 'a') {
+                    values[c - 'a' + 'A'] = static_cast<std::int8_t>(i);
+                }
+            }
+            return values;
+        }
+
+        constexpr auto hex_values    = make_values(hex_digits, 16, true);
+        constexpr auto base64_values = make_values(base64_digits, 64, false);
+
+        inline std::uint8_t byte(char c) noexcept
+        {
+            return static_cast<std::uint8_t>(c);
+        }
+
+        //
+        // Scalar kernels, which also finish what the vector kernels leave.
+        //
+
+        void hex_encode_scalar(
+            const char* in, std::size_t n, char* out) noexcept
+        {
+            for (std::size_t i = 0; i < n; ++i) {
+                *out++ = hex_digits[byte(in[i]) >> 4];
+                *out++ = hex_digits[byte(in[i]) & 0x0F];
+            }
+        }
+
+        // n is the number of characters (even); false if any is not hex
+        bool hex_decode_scalar(
+            const char* in, std::size_t n, char* out) noexcept
+        {
+            for (std::size_t i = 0; i < n; i += 2) {
+                const auto hi = hex_values[byte(in[i])];
+                const auto lo = hex_values[byte(in[i + 1])];
+                if ((hi | lo) < 0) {
+                    return false;
+                }
+                *out++ = static_cast<char>((hi << 4) | lo);
+            }
+            return true;
+        }
+
+        // including the padding of the last 1 or 2 bytes
+        void base64_encode_scalar(
+            const char* in, std::size_t n, char* out) noexcept
+        {
+            std::size_t i = 0;
+            for (; i + 3 <= n; i += 3) {
+                const std::uint32_t v = (std::uint32_t {byte(in[i])} << 16)
+                                        | (std::uint32_t {byte(in[i + 1])} << 8)
+                                        | byte(in[i + 2]);
+                *out++ = base64_digits[(v >> 18) & 0x3F];
+                *out++ = base64_digits[(v >> 12) & 0x3F];
+                *out++ = base64_digits[(v >> 6) & 0x3F];
+                *out++ = base64_digits[v & 0x3F];
+            }
+            if (i + 1 == n) {
+                const std::uint32_t v = std::uint32_t {byte(in[i])} << 16;
+                *out++ = base64_digits[(v >> 18) & 0x3F];
+                *out++ = base64_digits[(v >> 12) & 0x3F];
+                *out++ = '=';
+                *out++ = '=';
+            }
+            else if (i + 2 == n) {
+                const std::uint32_t v =
+                    (std::uint32_t {byte(in[i])} << 16)
+                    | (std::uint32_t {byte(in[i + 1])} << 8);
+                *out++ = base64_digits[(v >> 18) & 0x3F];
+                *out++ = base64_digits[(v >> 12) & 0x3F];
+                *out++ = base64_digits[(v >> 6) & 0x3F];
+                *out++ = '=';
+            }
+        }
+
+        // n is the number of characters without padding (not 4k + 1)
+        bool base64_decode_scalar(
+            const char* in, std::size_t n, char* out) noexcept
+        {
+            std::uint32_t v    = 0;
+            int           bits = 0;
+            for (std::size_t i = 0; i < n; ++i) {
+                const auto value = base64_values[byte(in[i])];
+                if (value < 0) {
+                    return false;
+                }
+                v = (v << 6) | static_cast<std::uint32_t>(value);
+                bits += 6;
+                if (bits >= 8) {
+                    bits -= 8;
+                    *out++ = static_cast<char>((v >> bits) & 0xFF);
+                }
+            }
+            // the bits left over (of a last, partial quantum) must be 0, so
+            // that only to_base64() of the bytes decodes to them
+            return (v & ((std::uint32_t {1} << bits) - 1)) == 0;
+        }
+
+#if defined(STUFF_AVX2_DISPATCH)
+
+        //
+        // AVX2 kernels: each converts as much of the input as it can in
+        // blocks and returns how much it converted (of in), stopping early at
+        // a block with an invalid character.
+        //
+
+        STUFF_TARGET_AVX2 std::size_t hex_encode_avx2(
+            const char* in, std::size_t n, char* out) noexcept
+        {
+            const auto digits = _mm256_setr_epi8('0', '1', '2', '3', '4', '5',
+                '6', '7', '8', '9', 'a', 'b', 'c', 'd', 'e', 'f', '0', '1',
+                '2', '3', '4', '5', '6', '7', '8', '9', 'a', 'b', 'c', 'd',
+                'e', 'f');
+            const auto nibble = _mm256_set1_epi8(0x0F);
+
+            std::size_t i = 0;
+            for (; i + 32 <= n; i += 32) {
+                const auto x = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(in + i));
+                const auto hi = _mm256_shuffle_epi8(
+                    digits, _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+                const auto lo =
+                    _mm256_shuffle_epi8(digits, _mm256_and_si256(x, nibble));
+
+                // interleave within each 128-bit lane, then put lanes in order
+                const auto a = _mm256_unpacklo_epi8(hi, lo);
+                const auto b = _mm256_unpackhi_epi8(hi, lo);
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + 2 * i),
+                    _mm256_permute2x128_si256(a, b, 0x20));
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(out + 2 * i + 32),
+                    _mm256_permute2x128_si256(a, b, 0x31));
+            }
+            return i;
+        }
+
+        // 32 characters to their values; false if any is not hex
+        STUFF_TARGET_AVX2 inline bool hex_values_avx2(
+            const char* in, __m256i& values) noexcept
+        {
+            const auto x =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(in));
+            const auto digit  = _mm256_sub_epi8(x, _mm256_set1_epi8('0'));
+            const auto letter = _mm256_sub_epi8(
+                _mm256_or_si256(x, _mm256_set1_epi8(0x20)),
+                _mm256_set1_epi8('a'));
+            const auto is_digit = _mm256_cmpeq_epi8(
+                _mm256_min_epu8(digit, _mm256_set1_epi8(9)), digit);
+            const auto is_letter = _mm256_cmpeq_epi8(
+                _mm256_min_epu8(letter, _mm256_set1_epi8(5)), letter);
+
+            values = _mm256_blendv_epi8(
+                _mm256_add_epi8(letter, _mm256_set1_epi8(10)), digit, is_digit);
+            return _mm256_movemask_epi8(_mm256_or_si256(is_digit, is_letter))
+                   == -1;
+        }
+
+        STUFF_TARGET_AVX2 std::size_t hex_decode_avx2(
+            const char* in, std::size_t n, char* out) noexcept
+        {
+            // (high << 4) + low for each pair of characters
+            const auto weights = _mm256_set1_epi16(0x0110);
+
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                __m256i first;
+                __m256i second;
+                if (!hex_values_avx2(in + i, first)
+                    || !hex_values_avx2(in + i + 32, second)) {
+                    break;
+                }
+                const auto packed =
+                    _mm256_packus_epi16(_mm256_maddubs_epi16(first, weights),
+                        _mm256_maddubs_epi16(second, weights));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i / 2),
+                    _mm256_permute4x64_epi64(packed, 0xD8));
+            }
+            return i;
+        }
+
+        //
+        // Base64 follows "Faster Base64 Encoding and Decoding Using AVX2
+        // Instructions" (Mula, Kurz, and Lemire): 24 bytes to 32 characters
+        // and back per step.
+        //
+
+        STUFF_TARGET_AVX2 std::size_t base64_encode_avx2(
+            const char* in, std::size_t n, char* out) noexcept
+        {
+            // each 128-bit lane gets 12 bytes, as 4 groups of 3 bytes: b, a,
+            // c, b (i.e., so each group of 6 bits is in a 16-bit word)
+            const auto spread = _mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6,
+                8, 7, 10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9,
+                11, 10);
+            const auto shift = _mm256_setr_epi8('a' - 26, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0, 'a' - 26,
+                '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A',
+                0, 0);
+
+            std::size_t i = 0;
+            std::size_t j = 0;
+            // 16 bytes are loaded at i + 12, so 4 more than are used
+            for (; i + 28 <= n; i += 24, j += 32) {
+                const auto lo =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+                const auto hi = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(in + i + 12));
+                auto x = _mm256_shuffle_epi8(
+                    _mm256_inserti128_si256(_mm256_castsi128_si256(lo), hi, 1),
+                    spread);
+
+                // move each group of 6 bits to its own byte
+                const auto ac = _mm256_mulhi_epu16(
+                    _mm256_and_si256(x, _mm256_set1_epi32(0x0FC0FC00)),
+                    _mm256_set1_epi32(0x04000040));
+                const auto bd = _mm256_mullo_epi16(
+                    _mm256_and_si256(x, _mm256_set1_epi32(0x003F03F0)),
+                    _mm256_set1_epi32(0x01000010));
+                x = _mm256_or_si256(ac, bd);
+
+                // 0-25 -> 13, 26-51 -> 0, 52-63 -> 1-12, then add the shift
+                auto index = _mm256_subs_epu8(x, _mm256_set1_epi8(51));
+                index      = _mm256_or_si256(index,
+                    _mm256_and_si256(
+                        _mm256_cmpgt_epi8(_mm256_set1_epi8(26), x),
+                        _mm256_set1_epi8(13)));
+                x = _mm256_add_epi8(x, _mm256_shuffle_epi8(shift, index));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j), x);
+            }
+            return i;
+        }
+
+        // note: writes 32 bytes for each 24 decoded (i.e., out needs room)
+        STUFF_TARGET_AVX2 std::size_t base64_decode_avx2(
+            const char* in, std::size_t n, char* out) noexcept
+        {
+            const auto lut_lo = _mm256_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11,
+                0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B,
+                0x1A, 0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+            const auto lut_hi = _mm256_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04,
+                0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10,
+                0x10, 0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10,
+                0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+            const auto lut_roll = _mm256_setr_epi8(0, 16, 19, 4, -65, -65, -71,
+                -71, 0, 0, 0, 0, 0, 0, 0, 0, 0, 16, 19, 4, -65, -65, -71, -71,
+                0, 0, 0, 0, 0, 0, 0, 0);
+            const auto pack = _mm256_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14,
+                13, 12, -1, -1, -1, -1, 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12,
+                -1, -1, -1, -1);
+            const auto nibble = _mm256_set1_epi8(0x0F);
+
+            std::size_t i = 0;
+            std::size_t j = 0;
+            for (; i + 32 <= n; i += 32, j += 24) {
+                auto x = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(in + i));
+                const auto hi_nibbles =
+                    _mm256_and_si256(_mm256_srli_epi32(x, 4), nibble);
+                const auto lo_nibbles = _mm256_and_si256(x, nibble);
+
+                // invalid if the classes of both nibbles have a bit in common
+                const auto lo = _mm256_shuffle_epi8(lut_lo, lo_nibbles);
+                const auto hi = _mm256_shuffle_epi8(lut_hi, hi_nibbles);
+                if (!_mm256_testz_si256(lo, hi)) {
+                    break;
+                }
+
+                // character -> 6 bits ('/' shares its high nibble with '+')
+                const auto is_slash =
+                    _mm256_cmpeq_epi8(x, _mm256_set1_epi8('/'));
+                x = _mm256_add_epi8(x,
+                    _mm256_shuffle_epi8(
+                        lut_roll, _mm256_add_epi8(is_slash, hi_nibbles)));
+
+                // join 4 x 6 bits to 3 bytes
+                x = _mm256_maddubs_epi16(x, _mm256_set1_epi32(0x01400140));
+                x = _mm256_madd_epi16(x, _mm256_set1_epi32(0x00011000));
+                x = _mm256_shuffle_epi8(x, pack);
+                x = _mm256_permutevar8x32_epi32(
+                    x, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(out + j), x);
+            }
+            return i;
+        }
+
+#endif
+
+    } // namespace
+
+    std::string to_hex(std::string_view bytes)
+    {
+        std::string result(2 * bytes.size(), '\0');
+        std::size_t done = 0;
+#if defined(STUFF_AVX2_DISPATCH)
+        if (core::detail::use_avx2(bytes.size())) {
+            done = hex_encode_avx2(bytes.data(), bytes.size(), result.data());
+        }
+#endif
+        hex_encode_scalar(
+            bytes.data() + done, bytes.size() - done, result.data() + 2 * done);
+        return result;
+    }
+
+    container::byte_array from_hex(std::string_view text)
+    {
+        STUFF_EXPECTS(text.size() % 2 == 0, encoding_error,
+            "hexadecimal has an odd length ({})", text.size());
+
+        container::byte_array result(text.size() / 2);
+        std::size_t           done = 0;
+#if defined(STUFF_AVX2_DISPATCH)
+        if (core::detail::use_avx2(text.size())) {
+            done = hex_decode_avx2(text.data(), text.size(), result.data());
+        }
+#endif
+        STUFF_EXPECTS(hex_decode_scalar(text.data() + done, text.size() - done,
+                          result.data() + done / 2),
+            encoding_error, "\"{}\" is not hexadecimal", text.substr(0, 64));
+        return result;
+    }
+
+    std::string to_base64(std::string_view bytes)
+    {
+        std::string result(4 * ((bytes.size() + 2) / 3), '\0');
+        std::size_t done = 0;
+#if defined(STUFF_AVX2_DISPATCH)
+        if (core::detail::use_avx2(bytes.size())) {
+            done =
+                base64_encode_avx2(bytes.data(), bytes.size(), result.data());
+        }
+#endif
+        base64_encode_scalar(bytes.data() + done, bytes.size() - done,
+            result.data() + done / 3 * 4);
+        return result;
+    }
+
+    container::byte_array from_base64(std::string_view text)
+    {
+        // padding is optional, but must be complete if present
+        if (!text.empty() && text.back() == '=') {
+            STUFF_EXPECTS(text.size() % 4 == 0, encoding_error,
+                "base64 has incomplete padding");
+            text.remove_suffix(text.size() >= 2 && text[text.size() - 2] == '='
+                                   ? 2
+                                   : 1);
+        }
+        STUFF_EXPECTS(text.size() % 4 != 1, encoding_error,
+            "base64 has an invalid length ({})", text.size());
+
+        const auto size = text.size() / 4 * 3
+                          + (text.size() % 4 == 0 ? 0 : text.size() % 4 - 1);
+        container::byte_array result;
+        std::size_t           done = 0;
+#if defined(STUFF_AVX2_DISPATCH)
+        if (core::detail::use_avx2(text.size())) {
+            // 32 bytes are written for the last 24
+            result.resize(size + 8);
+            done = base64_decode_avx2(text.data(), text.size(), result.data());
+        }
+#endif
+        result.resize(size);
+        STUFF_EXPECTS(base64_decode_scalar(text.data() + done,
+                          text.size() - done, result.data() + done / 4 * 3),
+            encoding_error, "\"{}\" is not base64", text.substr(0, 64));
+        return result;
+    }
+
+} // namespace stuff::string
@@ -0,0 +1,74 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <charconv>
+#include <stuff/string/format.h>
+
+namespace stuff::string {
+
+    char* format_number(char* out, float value) noexcept
+    {
+        return std::to_chars(out, out + max_number_size<float>, value).ptr;
+    }
+
+    char* format_number(char* out, double value) noexcept
+    {
+        return std::to_chars(out, out + max_number_size<double>, value).ptr;
+    }
+
+    char* format_fixed(
+        char* first, char* last, double value, int precision) noexcept
+    {
+        auto [ptr, ec] = std::to_chars(
+            first, last, value, std::chars_format::fixed, precision);
+        return ec == std::errc {} ? ptr : nullptr;
+    }
+
+    output_buffer::output_buffer(std::size_t capacity)
+    : m_data {new char[std::max<std::size_t>(capacity, 1)]},
+      m_size {0},
+      m_capacity {std::max<std::size_t>(capacity, 1)}
+    {
+    }
+
+    output_buffer& output_buffer::append_fixed(double value, int precision)
+    {
+        // try the space at hand and only grow if the number does not fit
+        while (true) {
+            char* first = reserve(max_number_size<double>);
+            char* last  = m_data.get() + m_capacity;
+            if (char* end = format_fixed(first, last, value, precision)) {
+                m_size = static_cast<std::size_t>(end - m_data.get());
+                return *this;
+            }
+            grow(m_capacity * 2);
+        }
+    }
+
+    void output_buffer::grow(std::size_t required)
+    {
+        auto capacity = std::max(required, m_capacity * 2);
+        auto data     = std::unique_ptr<char[]> {new char[capacity]};
+        if (m_size != 0) {
+            std::memcpy(data.get(), m_data.get(), m_size);
+        }
+        m_data     = std::move(data);
+        m_capacity = capacity;
+    }
+
+} // namespace stuff::string
@@ -0,0 +1,457 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <stuff/core/cpu.h>
+#include <stuff/string/hash.h>
+
+namespace stuff::string {
+
+    namespace {
+
+        constexpr std::uint64_t prime32_1 = 0x9E3779B1U;
+        constexpr std::uint64_t prime32_2 = 0x85EBCA77U;
+        constexpr std::uint64_t prime32_3 = 0xC2B2AE3DU;
+        constexpr std::uint64_t prime64_1 = 0x9E3779B185EBCA87ULL;
+        constexpr std::uint64_t prime64_2 = 0xC2B2AE3D27D4EB4FULL;
+        constexpr std::uint64_t prime64_3 = 0x165667B19E3779F9ULL;
+        constexpr std::uint64_t prime64_4 = 0x85EBCA77C2B2AE63ULL;
+        constexpr std::uint64_t prime64_5 = 0x27D4EB2F165667C5ULL;
+
+        //
+        // 192 bytes of key material (from splitmix64) mixed into the input.
+        // Each 64 byte stripe of a block uses the next 8 bytes of it.
+        //
+        constexpr std::size_t secret_words      = 24;
+        constexpr std::size_t stripe_size       = 64;
+        constexpr std::size_t stripes_per_block = secret_words - 8;
+        constexpr std::size_t block_size = stripe_size * stripes_per_block;
+
+        constexpr std::array<std::uint64_t, secret_words> make_secret()
+        {
+            std::array<std::uint64_t, secret_words> secret {};
+            std::uint64_t                           x = 0;
+            for (auto& word : secret) {
+                x += 0x9E3779B97F4A7C15ULL;
+                auto z = x;
+                z      = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+                z      = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+                word   = z ^ (z >> 31);
+            }
+            return secret;
+        }
+
+        alignas(32) constexpr auto secret = make_secret();
+
+        inline std::uint64_t read64(const char* p) noexcept
+        {
+            std::uint64_t v;
+            std::memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            v = __builtin_bswap64(v);
+#endif
+            return v;
+        }
+
+        inline std::uint32_t read32(const char* p) noexcept
+        {
+            std::uint32_t v;
+            std::memcpy(&v, p, sizeof(v));
+#if __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+            v = __builtin_bswap32(v);
+#endif
+            return v;
+        }
+
+        inline std::uint64_t rotl(std::uint64_t v, int bits) noexcept
+        {
+            return (v << bits) | (v >> (64 - bits));
+        }
+
+        // the low and high 64 bits of the 128-bit product, combined
+        inline std::uint64_t mul128_fold64(
+            std::uint64_t a, std::uint64_t b) noexcept
+        {
+#if defined(__SIZEOF_INT128__)
+            __extension__ using uint128 = unsigned __int128;
+            const auto product          = static_cast<uint128>(a) * b;
+            return static_cast<std::uint64_t>(product)
+                   ^ static_cast<std::uint64_t>(product >> 64);
+#else
+            const std::uint64_t lo_lo = (a & 0xFFFFFFFF) * (b & 0xFFFFFFFF);
+            const std::uint64_t hi_lo = (a >> 32) * (b & 0xFFFFFFFF);
+            const std::uint64_t lo_hi = (a & 0xFFFFFFFF) * (b >> 32);
+            const std::uint64_t hi_hi = (a >> 32) * (b >> 32);
+            const std::uint64_t cross =
+                (lo_lo >> 32) + (hi_lo & 0xFFFFFFFF) + lo_hi;
+            const std::uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+            const std::uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFF);
+            return lower ^ upper;
+#endif
+        }
+
+        inline std::uint64_t avalanche(std::uint64_t h) noexcept
+        {
+            h ^= h >> 37;
+            h *= 0x165667919E3779F9ULL;
+            return h ^ (h >> 32);
+        }
+
+        inline std::uint64_t avalanche64(std::uint64_t h) noexcept
+        {
+            h ^= h >> 33;
+            h *= prime64_2;
+            h ^= h >> 29;
+            h *= prime64_3;
+            return h ^ (h >> 32);
+        }
+
+        inline std::uint64_t rrmxmx(std::uint64_t h, std::uint64_t n) noexcept
+        {
+            h ^= rotl(h, 49) ^ rotl(h, 24);
+            h *= 0x9FB21C651E98DF25ULL;
+            h ^= (h >> 35) + n;
+            h *= 0x9FB21C651E98DF25ULL;
+            return h ^ (h >> 28);
+        }
+
+        //
+        // Short inputs: a few multiplies of the whole input.
+        //
+
+        std::uint64_t hash_1to3(
+            const char* p, std::size_t n, std::uint64_t seed) noexcept
+        {
+            const std::uint32_t c1 = static_cast<std::uint8_t>(p[0]);
+            const std::uint32_t c2 = static_cast<std::uint8_t>(p[n >> 1]);
+            const std::uint32_t c3 = static_cast<std::uint8_t>(p[n - 1]);
+            const std::uint32_t combined = (c1 << 16) | (c2 << 24) | c3
+                                           | static_cast<std::uint32_t>(n << 8);
+            const std::uint64_t flip =
+                ((secret[0] & 0xFFFFFFFF) ^ (secret[0] >> 32)) + seed;
+            return avalanche64(combined ^ flip);
+        }
+
+        std::uint64_t hash_4to8(
+            const char* p, std::size_t n, std::uint64_t seed) noexcept
+        {
+            seed ^= std::uint64_t {__builtin_bswap32(
+                        static_cast<std::uint32_t>(seed))}
+                    << 32;
+            const std::uint64_t first = read32(p);
+            const std::uint64_t last  = read32(p + n - 4);
+            const std::uint64_t flip  = (secret[1] ^ secret[2]) - seed;
+            return rrmxmx((last + (first << 32)) ^ flip, n);
+        }
+
+        std::uint64_t hash_9to16(
+            const char* p, std::size_t n, std::uint64_t seed) noexcept
+        {
+            const auto lo = read64(p) ^ ((secret[3] ^ secret[4]) + seed);
+            const auto hi =
+                read64(p + n - 8) ^ ((secret[5] ^ secret[6]) - seed);
+            return avalanche(
+                n + __builtin_bswap64(lo) + hi + mul128_fold64(lo, hi));
+        }
+
+        inline std::uint64_t mix16(
+            const char* p, std::size_t word, std::uint64_t seed) noexcept
+        {
+            return mul128_fold64(read64(p) ^ (secret[word] + seed),
+                read64(p + 8) ^ (secret[word + 1] - seed));
+        }
+
+        // 16 bytes at a time from both ends, toward the middle
+        std::uint64_t hash_17to128(
+            const char* p, std::size_t n, std::uint64_t seed) noexcept
+        {
+            std::uint64_t acc = n * prime64_1;
+            if (n > 32) {
+                if (n > 64) {
+                    if (n > 96) {
+                        acc += mix16(p + 48, 12, seed);
+                        acc += mix16(p + n - 64, 14, seed);
+                    }
+                    acc += mix16(p + 32, 8, seed);
+                    acc += mix16(p + n - 48, 10, seed);
+                }
+                acc += mix16(p + 16, 4, seed);
+                acc += mix16(p + n - 32, 6, seed);
+            }
+            acc += mix16(p, 0, seed);
+            acc += mix16(p + n - 16, 2, seed);
+            return avalanche(acc);
+        }
+
+        //
+        // Long inputs: 64 bytes (a stripe) at a time into eight accumulators.
+        // Each accumulator adds the product of the low and high 32 bits of
+        // the input (mixed with the secret) and its neighbor's input. After
+        // each block of stripes, the accumulators are scrambled.
+        //
+
+        using accumulators = std::array<std::uint64_t, 8>;
+
+        inline accumulators initial_accumulators(std::uint64_t seed) noexcept
+        {
+            accumulators acc {prime32_3, prime64_1, prime64_2, prime64_3,
+                prime64_4, prime32_2, prime64_5, prime32_1};
+            for (std::size_t i = 0; i < acc.size(); i += 2) {
+                acc[i] += seed;
+                acc[i + 1] -= seed;
+            }
+            return acc;
+        }
+
+        inline std::uint64_t merge(
+            const accumulators& acc, std::size_t n) noexcept
+        {
+            std::uint64_t result = n * prime64_1;
+            for (std::size_t i = 0; i < 4; ++i) {
+                result += mul128_fold64(acc[2 * i] ^ secret[3 + 2 * i],
+                    acc[2 * i + 1] ^ secret[4 + 2 * i]);
+            }
+            return avalanche(result);
+        }
+
+        inline void accumulate_stripe(
+            accumulators& acc, const char* p, std::size_t word) noexcept
+        {
+            for (std::size_t i = 0; i < 8; ++i) {
+                const auto data = read64(p + 8 * i);
+                const auto key  = data ^ secret[word + i];
+                acc[i ^ 1] += data;
+                acc[i] += (key & 0xFFFFFFFF) * (key >> 32);
+            }
+        }
+
+        inline void scramble(accumulators& acc) noexcept
+        {
+            for (std::size_t i = 0; i < 8; ++i) {
+                auto a = acc[i];
+                a ^= a >> 47;
+                a ^= secret[stripes_per_block + i];
+                acc[i] = a * prime32_1;
+            }
+        }
+
+        std::uint64_t hash_long(
+            const char* p, std::size_t n, std::uint64_t seed) noexcept
+        {
+            auto acc = initial_accumulators(seed);
+
+            // the last stripe is always hashed on its own, below
+            const auto blocks = (n - 1) / block_size;
+            for (std::size_t b = 0; b < blocks; ++b) {
+                for (std::size_t s = 0; s < stripes_per_block; ++s) {
+                    accumulate_stripe(
+                        acc, p + b * block_size + s * stripe_size, s);
+                }
+                scramble(acc);
+            }
+            const auto stripes = ((n - 1) - blocks * block_size) / stripe_size;
+            for (std::size_t s = 0; s < stripes; ++s) {
+                accumulate_stripe(
+                    acc, p + blocks * block_size + s * stripe_size, s);
+            }
+            accumulate_stripe(acc, p + n - stripe_size, 13);
+            return merge(acc, n);
+        }
+
+#if defined(STUFF_AVX2_DISPATCH)
+
+        //
+        // The same as hash_long(), but four accumulators at a time (i.e.,
+        // _mm256_mul_epu32 is the 32 x 32 bit multiply of each).
+        //
+
+        STUFF_TARGET_AVX2 inline void accumulate_stripe_avx2(
+            __m256i acc[2], const char* p, std::size_t word) noexcept
+        {
+            for (int i = 0; i < 2; ++i) {
+                const auto data = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(p + 32 * i));
+                const auto key = _mm256_xor_si256(data,
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                        secret.data() + word + 4 * i)));
+                const auto product =
+                    _mm256_mul_epu32(key, _mm256_srli_epi64(key, 32));
+                const auto swapped = _mm256_shuffle_epi32(data, 0x4E);
+                acc[i] = _mm256_add_epi64(
+                    acc[i], _mm256_add_epi64(product, swapped));
+            }
+        }
+
+        STUFF_TARGET_AVX2 inline void scramble_avx2(__m256i acc[2]) noexcept
+        {
+            const auto prime = _mm256_set1_epi64x(prime32_1);
+            for (int i = 0; i < 2; ++i) {
+                auto a =
+                    _mm256_xor_si256(acc[i], _mm256_srli_epi64(acc[i], 47));
+                a = _mm256_xor_si256(a,
+                    _mm256_loadu_si256(reinterpret_cast<const __m256i*>(
+                        secret.data() + stripes_per_block + 4 * i)));
+                const auto lo = _mm256_mul_epu32(a, prime);
+                const auto hi =
+                    _mm256_mul_epu32(_mm256_srli_epi64(a, 32), prime);
+                acc[i] = _mm256_add_epi64(lo, _mm256_slli_epi64(hi, 32));
+            }
+        }
+
+        STUFF_TARGET_AVX2 std::uint64_t hash_long_avx2(
+            const char* p, std::size_t n, std::uint64_t seed) noexcept
+        {
+            alignas(32) auto initial = initial_accumulators(seed);
+            __m256i          acc[2] {
+                _mm256_load_si256(
+                    reinterpret_cast<const __m256i*>(initial.data())),
+                _mm256_load_si256(
+                    reinterpret_cast<const __m256i*>(initial.data() + 4))};
+
+            const auto blocks = (n - 1) / block_size;
+            for (std::size_t b = 0; b < blocks; ++b) {
+                for (std::size_t s = 0; s < stripes_per_block; ++s) {
+                    accumulate_stripe_avx2(
+                        acc, p + b * block_size + s * stripe_size, s);
+                }
+                scramble_avx2(acc);
+            }
+            const auto stripes = ((n - 1) - blocks * block_size) / stripe_size;
+            for (std::size_t s = 0; s < stripes; ++s) {
+                accumulate_stripe_avx2(
+                    acc, p + blocks * block_size + s * stripe_size, s);
+            }
+            accumulate_stripe_avx2(acc, p + n - stripe_size, 13);
+
+            alignas(32) accumulators result;
+            _mm256_store_si256(
+                reinterpret_cast<__m256i*>(result.data()), acc[0]);
+            _mm256_store_si256(
+                reinterpret_cast<__m256i*>(result.data() + 4), acc[1]);
+            return merge(result, n);
+        }
+
+#endif
+
+        //
+        // CRC-32C in software: eight bytes at a time with eight tables
+        // (i.e., slicing-by-8).
+        //
+
+        using crc_tables = std::array<std::array<std::uint32_t, 256>, 8>;
+
+        constexpr crc_tables make_crc_tables()
+        {
+            crc_tables tables {};
+            for (std::uint32_t i = 0; i < 256; ++i) {
+                std::uint32_t crc = i;
+                for (int bit = 0; bit < 8; ++bit) {
+                    crc = (crc >> 1) ^ ((crc & 1) ? 0x82F63B78U : 0);
+                }
+                tables[0][i] = crc;
+            }
+            for (std::size_t k = 1; k < 8; ++k) {
+                for (std::size_t i = 0; i < 256; ++i) {
+                    const auto prev = tables[k - 1][i];
+                    tables[k][i]    = (prev >> 8) ^ tables[0][prev & 0xFF];
+                }
+            }
+            return tables;
+        }
+
+        constexpr auto crc_table = make_crc_tables();
+
+        std::uint32_t crc32c_scalar(
+            const char* p, std::size_t n, std::uint32_t crc) noexcept
+        {
+            for (; n >= 8; n -= 8, p += 8) {
+                const auto one = read32(p) ^ crc;
+                const auto two = read32(p + 4);
+                crc = crc_table[7][one & 0xFF] ^ crc_table[6][(one >> 8) & 0xFF]
+                      ^ crc_table[5][(one >> 16) & 0xFF]
+                      ^ crc_table[4][one >> 24] ^ crc_table[3][two & 0xFF]
+                      ^ crc_table[2][(two >> 8) & 0xFF]
+                      ^ crc_table[1][(two >> 16) & 0xFF]
+                      ^ crc_table[0][two >> 24];
+            }
+            for (; n > 0; --n, ++p) {
+                crc = crc_table[0][(crc ^ static_cast<std::uint8_t>(*p)) & 0xFF]
+                      ^ (crc >> 8);
+            }
+            return crc;
+        }
+
+#if defined(STUFF_AVX2_DISPATCH)
+
+        STUFF_TARGET_SSE42 std::uint32_t crc32c_sse42(
+            const char* p, std::size_t n, std::uint32_t crc) noexcept
+        {
+            std::uint64_t crc64 = crc;
+            for (; n >= 8; n -= 8, p += 8) {
+                crc64 = _mm_crc32_u64(crc64, read64(p));
+            }
+            crc = static_cast<std::uint32_t>(crc64);
+            for (; n > 0; --n, ++p) {
+                crc = _mm_crc32_u8(crc, static_cast<std::uint8_t>(*p));
+            }
+            return crc;
+        }
+
+#endif
+
+    } // namespace
+
+    std::uint64_t hash64(std::string_view view, std::uint64_t seed) noexcept
+    {
+        const char* p = view.data();
+        const auto  n = view.size();
+        if (n <= 16) {
+            if (n > 8) {
+                return hash_9to16(p, n, seed);
+            }
+            if (n >= 4) {
+                return hash_4to8(p, n, seed);
+            }
+            if (n > 0) {
+                return hash_1to3(p, n, seed);
+            }
+            return avalanche64(seed ^ (secret[7] ^ secret[8]));
+        }
+        if (n <= 128) {
+            return hash_17to128(p, n, seed);
+        }
+#if defined(STUFF_AVX2_DISPATCH)
+        if (core::detail::use_avx2(n, block_size)) {
+            return hash_long_avx2(p, n, seed);
+        }
+#endif
+        return hash_long(p, n, seed);
+    }
+
+    std::uint32_t crc32c(std::string_view view, std::uint32_t crc) noexcept
+    {
+#if defined(STUFF_AVX2_DISPATCH)
+        if (core::detail::have_sse42()) {
+            return ~crc32c_sse42(view.data(), view.size(), ~crc);
+        }
+#endif
+        return ~crc32c_scalar(view.data(), view.size(), ~crc);
+    }
+
+} // namespace stuff::string
@@ -0,0 +1,141 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <mutex>
+#include <stuff/string/intern.h>
+
+namespace stuff::string {
+
+    namespace detail {
+
+        char_arena::char_arena(std::size_t block_size)
+        : m_block_size {block_size}, m_used {0}, m_capacity {0}
+        {
+        }
+
+        std::string_view char_arena::store(std::string_view view)
+        {
+            if (m_blocks.empty() || m_used + view.size() > m_block_size) {
+                // a string larger than a block gets a block of its own
+                auto size = std::max(view.size(), m_block_size);
+                m_blocks.emplace_back(std::make_unique<char[]>(size));
+                m_used = 0;
+                m_capacity += size;
+            }
+
+            char* p = m_blocks.back().get() + m_used;
+            if (!view.empty()) {
+                std::memcpy(p, view.data(), view.size());
+            }
+            m_used += view.size();
+            return std::string_view {p, view.size()};
+        }
+
+    } // namespace detail
+
+    symbol_id symbol_table::intern(std::string_view view)
+    {
+        if (auto it = m_ids.find(view); it != m_ids.end()) {
+            return it->second;
+        }
+
+        STUFF_EXPECTS(m_views.size() < std::numeric_limits<symbol_id>::max(),
+            symbol_table_error, "too many symbols to intern \"{}\"", view);
+        auto id     = static_cast<symbol_id>(m_views.size());
+        auto stored = m_arena.store(view);
+        m_views.push_back(stored);
+        m_ids.emplace(stored, id);
+        return id;
+    }
+
+    std::optional<symbol_id> symbol_table::find(
+        std::string_view view) const noexcept
+    {
+        if (auto it = m_ids.find(view); it != m_ids.end()) {
+            return it->second;
+        }
+        return std::nullopt;
+    }
+
+    std::size_t concurrent_symbol_table::shard_count(unsigned shard_bits)
+    {
+        STUFF_EXPECTS(shard_bits < 16, symbol_table_error,
+            "too many shard bits ({})", shard_bits);
+        return std::size_t {1} << shard_bits;
+    }
+
+    concurrent_symbol_table::concurrent_symbol_table(unsigned shard_bits)
+    : m_shard_bits {shard_bits},
+      m_mask {shard_count(shard_bits) - 1},
+      m_shards {std::make_unique<shard[]>(m_mask + 1)}
+    {
+    }
+
+    symbol_id concurrent_symbol_table::intern(std::string_view view)
+    {
+        auto& s     = shard_of(view);
+        auto  index = static_cast<symbol_id>(&s - m_shards.get());
+
+        // most strings have been seen before, so try a shared lock first
+        {
+            std::shared_lock lock {s.mutex};
+            if (auto id = s.table.find(view)) {
+                return (*id << m_shard_bits) | index;
+            }
+        }
+
+        std::unique_lock lock {s.mutex};
+        STUFF_EXPECTS(s.table.size() <= (std::numeric_limits<symbol_id>::max()
+                                            >> m_shard_bits),
+            symbol_table_error, "too many symbols to intern \"{}\"", view);
+        return (s.table.intern(view) << m_shard_bits) | index;
+    }
+
+    std::optional<symbol_id> concurrent_symbol_table::find(
+        std::string_view view) const
+    {
+        auto&            s = shard_of(view);
+        std::shared_lock lock {s.mutex};
+        auto             id = s.table.find(view);
+        if (!id) {
+            return std::nullopt;
+        }
+        return (*id << m_shard_bits)
+               | static_cast<symbol_id>(&s - m_shards.get());
+    }
+
+    std::string_view concurrent_symbol_table::view(symbol_id id) const
+    {
+        auto&            s = m_shards[id & m_mask];
+        std::shared_lock lock {s.mutex};
+        return s.table.view(id >> m_shard_bits);
+    }
+
+    std::size_t concurrent_symbol_table::size() const
+    {
+        std::size_t result = 0;
+        for (std::size_t i = 0; i <= m_mask; ++i) {
+            std::shared_lock lock {m_shards[i].mutex};
+            result += m_shards[i].table.size();
+        }
+        return result;
+    }
+
+} // namespace stuff::string
@@ -0,0 +1,210 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <deque>
+#include <limits>
+#include <stuff/core/cpu.h>
+#include <stuff/string/match.h>
+
+namespace stuff::string {
+
+    namespace {
+
+        inline std::uint8_t byte(char c) noexcept
+        {
+            return static_cast<std::uint8_t>(c);
+        }
+
+#if defined(STUFF_AVX2_DISPATCH)
+
+        //
+        // Return the position of the first character in [i, n) (rounded down
+        // to 32 characters) that can start a pattern. A character is looked
+        // up by its low and high four bits (i.e., two table lookups of 32
+        // characters at once), where low[c & 15] has bit (c >> 4) set if c
+        // starts a pattern and high[h] is (1 << h). Only ASCII works.
+        //
+        STUFF_TARGET_AVX2 std::size_t skip_avx2(const char* p, std::size_t i,
+            std::size_t n, const std::uint8_t* low,
+            const std::uint8_t* high) noexcept
+        {
+            const auto low_table = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(low)));
+            const auto high_table = _mm256_broadcastsi128_si256(
+                _mm_loadu_si128(reinterpret_cast<const __m128i*>(high)));
+            const auto nibble = _mm256_set1_epi8(0x0F);
+            const auto zero   = _mm256_setzero_si256();
+
+            for (; i + 32 <= n; i += 32) {
+                const auto x = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(p + i));
+                const auto lo = _mm256_shuffle_epi8(
+                    low_table, _mm256_and_si256(x, nibble));
+                const auto hi = _mm256_shuffle_epi8(high_table,
+                    _mm256_and_si256(_mm256_srli_epi16(x, 4), nibble));
+                const auto mask = ~static_cast<unsigned>(_mm256_movemask_epi8(
+                    _mm256_cmpeq_epi8(_mm256_and_si256(lo, hi), zero)));
+                if (mask != 0) {
+                    return i + static_cast<std::size_t>(__builtin_ctz(mask));
+                }
+            }
+            return i;
+        }
+
+#endif
+
+    } // namespace
+
+    multi_matcher::multi_matcher(
+        std::initializer_list<std::string_view> patterns)
+    : multi_matcher {patterns.begin(), patterns.end()}
+    {
+    }
+
+    void multi_matcher::add(std::string_view pattern)
+    {
+        STUFF_EXPECTS(!pattern.empty(), multi_matcher_error,
+            "pattern {} is empty", m_patterns.size());
+        m_patterns.emplace_back(pattern);
+        m_lengths.push_back(pattern.size());
+    }
+
+    void multi_matcher::compile()
+    {
+        STUFF_EXPECTS(
+            m_patterns.size() < std::numeric_limits<std::uint32_t>::max(),
+            multi_matcher_error, "too many patterns ({})", m_patterns.size());
+
+        // only characters in the patterns need a column; all others are 0
+        for (const auto& pattern : m_patterns) {
+            for (char c : pattern) {
+                if (m_class[byte(c)] == 0) {
+                    STUFF_EXPECTS(m_classes < 256, multi_matcher_error,
+                        "too many different characters");
+                    m_class[byte(c)] = static_cast<std::uint8_t>(m_classes++);
+                }
+            }
+        }
+
+        // build the trie (0 is the root and, for now, no transition)
+        m_next.assign(m_classes, 0);
+        m_output.assign(1, 0);
+        for (std::size_t k = 0; k < m_patterns.size(); ++k) {
+            state_type state = 0;
+            for (char c : m_patterns[k]) {
+                auto& next = m_next[state * m_classes + m_class[byte(c)]];
+                if (next == 0) {
+                    STUFF_EXPECTS(m_output.size()
+                                      < std::numeric_limits<state_type>::max(),
+                        multi_matcher_error, "too many states");
+                    next = static_cast<state_type>(m_output.size());
+                    m_next.resize(m_next.size() + m_classes, 0);
+                    m_output.push_back(0);
+                }
+                state = m_next[state * m_classes + m_class[byte(c)]];
+            }
+            if (m_output[state] == 0) {
+                m_output[state] = static_cast<std::uint32_t>(k + 1);
+            }
+
+            const auto first = byte(m_patterns[k].front());
+            m_is_start[first] = true;
+            if (first < 0x80) {
+                m_start_low[first & 0x0F] |=
+                    static_cast<std::uint8_t>(1 << (first >> 4));
+            }
+            else {
+                m_ascii_start = false;
+            }
+        }
+        for (std::size_t h = 0; h < 8; ++h) {
+            m_start_high[h] = static_cast<std::uint8_t>(1 << h);
+        }
+
+        // In breadth first order, the state for the longest suffix that is
+        // also a prefix (i.e., the failure link) is complete before it is
+        // needed. Missing transitions become those of the failure link.
+        std::vector<state_type> fail(m_output.size(), 0);
+        std::deque<state_type>  queue;
+        for (std::size_t c = 0; c < m_classes; ++c) {
+            if (m_next[c] != 0) {
+                queue.push_back(m_next[c]);
+            }
+        }
+        while (!queue.empty()) {
+            const auto state = queue.front();
+            queue.pop_front();
+
+            const auto row      = state * m_classes;
+            const auto fail_row = fail[state] * m_classes;
+            for (std::size_t c = 0; c < m_classes; ++c) {
+                auto& next = m_next[row + c];
+                if (next == 0) {
+                    next = m_next[fail_row + c];
+                    continue;
+                }
+                fail[next] = m_next[fail_row + c];
+                if (m_output[next] == 0) {
+                    // a shorter pattern ends here
+                    m_output[next] = m_output[fail[next]];
+                }
+                queue.push_back(next);
+            }
+        }
+
+        m_patterns.clear();
+        m_patterns.shrink_to_fit();
+    }
+
+    std::size_t multi_matcher::skip(
+        const char* p, std::size_t i, std::size_t n) const noexcept
+    {
+#if defined(STUFF_AVX2_DISPATCH)
+        if (m_ascii_start && core::detail::use_avx2(n - i)) {
+            i = skip_avx2(p, i, n, m_start_low.data(), m_start_high.data());
+        }
+#endif
+        while (i < n && !m_is_start[byte(p[i])]) {
+            ++i;
+        }
+        return i;
+    }
+
+    std::optional<multi_matcher::match> multi_matcher::find(
+        std::string_view view) const noexcept
+    {
+        const char*       p     = view.data();
+        const std::size_t n     = view.size();
+        state_type        state = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            if (state == 0 && !m_is_start[byte(p[i])]) {
+                i = skip(p, i, n);
+                if (i == n) {
+                    break;
+                }
+            }
+
+            state = m_next[state * m_classes + m_class[byte(p[i])]];
+            if (m_output[state] != 0) {
+                const auto k = m_output[state] - 1;
+                return match {k, i + 1 - m_lengths[k]};
+            }
+        }
+        return std::nullopt;
+    }
+
+} // namespace stuff::string
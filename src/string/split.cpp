@@ -15,10 +15,234 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stuff/core/cpu.h>
 #include <stuff/string/split.h>
 
+#if defined(__SSE2__)
+    #include <emmintrin.h>
+#endif
+
 namespace stuff::string {
 
+    namespace {
+
+        // separators longer than this are found with Horspool
+        constexpr std::size_t max_short_separator = 32;
+
+        // Find a short separator (two or more characters) by comparing its
+        // first and last characters against 16 candidate positions at once.
+        // Only candidates where both match need the middle compared.
+        std::size_t find_short(
+            std::string_view view, std::string_view sep) noexcept
+        {
+            const auto  n    = view.size();
+            const auto  m    = sep.size();
+            const char* data = view.data();
+            std::size_t i    = 0;
+
+#if defined(__SSE2__)
+            const auto first = _mm_set1_epi8(sep.front());
+            const auto last  = _mm_set1_epi8(sep.back());
+            for (; i + m - 1 + 16 <= n; i += 16) {
+                const auto block_first = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(data + i));
+                const auto block_last = _mm_loadu_si128(
+                    reinterpret_cast<const __m128i*>(data + i + m - 1));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(
+                    _mm_and_si128(_mm_cmpeq_epi8(block_first, first),
+                        _mm_cmpeq_epi8(block_last, last))));
+                while (mask != 0) {
+                    const auto bit = static_cast<std::size_t>(
+                        __builtin_ctz(mask));
+                    if (std::memcmp(data + i + bit + 1, sep.data() + 1, m - 2)
+                        == 0) {
+                        return i + bit;
+                    }
+                    mask &= mask - 1;
+                }
+            }
+#endif
+
+            // the remainder (or everything without SSE2)
+            for (; i + m <= n; ++i) {
+                if (data[i] == sep.front() && data[i + m - 1] == sep.back()
+                    && std::memcmp(data + i + 1, sep.data() + 1, m - 2) == 0) {
+                    return i;
+                }
+            }
+            return std::string_view::npos;
+        }
+
+        // Find a long separator with Boyer-Moore-Horspool.
+        std::size_t find_long(std::string_view view, std::string_view sep,
+            const std::array<std::uint8_t, 256>& skip) noexcept
+        {
+            const auto  n    = view.size();
+            const auto  m    = sep.size();
+            const char* data = view.data();
+            std::size_t i    = 0;
+            while (i + m <= n) {
+                const auto c = static_cast<unsigned char>(data[i + m - 1]);
+                if (c == static_cast<unsigned char>(sep.back())
+                    && std::memcmp(data + i, sep.data(), m - 1) == 0) {
+                    return i;
+                }
+                // a skip of 255 is safe for longer separators, just slower
+                i += std::max<std::size_t>(skip[c], 1);
+            }
+            return std::string_view::npos;
+        }
+
+        //
+        // Find the k-th (one-based) separator by counting the separators in
+        // 64 character blocks (i.e., a bit mask and popcount) rather than
+        // finding each one. If there are fewer than k separators, return npos
+        // and reduce k by the number found.
+        //
+
+        std::size_t find_nth_scalar(
+            const char* p, std::size_t n, char sep, std::size_t& k) noexcept
+        {
+            const char* it  = p;
+            const char* end = p + n;
+            while (it != end) {
+                const auto* found = static_cast<const char*>(
+                    std::memchr(it, sep, static_cast<std::size_t>(end - it)));
+                if (found == nullptr) {
+                    break;
+                }
+                if (--k == 0) {
+                    return static_cast<std::size_t>(found - p);
+                }
+                it = found + 1;
+            }
+            return std::string_view::npos;
+        }
+
+        // the position of the k-th (one-based) set bit of mask
+        inline std::size_t select_bit(
+            std::uint64_t mask, std::size_t k) noexcept
+        {
+            for (; k > 1; --k) {
+                mask &= mask - 1;
+            }
+            return static_cast<std::size_t>(__builtin_ctzll(mask));
+        }
+
+        std::size_t find_nth_baseline(
+            const char* p, std::size_t n, char sep, std::size_t& k) noexcept
+        {
+            std::size_t i = 0;
+#if defined(__SSE2__)
+            const auto s = _mm_set1_epi8(sep);
+            for (; i + 64 <= n; i += 64) {
+                std::uint64_t mask = 0;
+                for (int j = 0; j < 4; ++j) {
+                    const auto block = _mm_loadu_si128(
+                        reinterpret_cast<const __m128i*>(p + i + 16 * j));
+                    mask |= static_cast<std::uint64_t>(static_cast<unsigned>(
+                                _mm_movemask_epi8(_mm_cmpeq_epi8(block, s))))
+                            << (16 * j);
+                }
+                const auto count =
+                    static_cast<std::size_t>(__builtin_popcountll(mask));
+                if (count >= k) {
+                    return i + select_bit(mask, k);
+                }
+                k -= count;
+            }
+#endif
+            const auto pos = find_nth_scalar(p + i, n - i, sep, k);
+            return pos == std::string_view::npos ? pos : i + pos;
+        }
+
+#if defined(STUFF_AVX2_DISPATCH)
+
+        STUFF_TARGET_AVX2_POPCNT std::size_t find_nth_avx2(
+            const char* p, std::size_t n, char sep, std::size_t& k) noexcept
+        {
+            const auto  s = _mm256_set1_epi8(sep);
+            std::size_t i = 0;
+            for (; i + 64 <= n; i += 64) {
+                const auto lo = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(p + i));
+                const auto hi = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(p + i + 32));
+                const auto mask =
+                    static_cast<std::uint64_t>(static_cast<unsigned>(
+                        _mm256_movemask_epi8(_mm256_cmpeq_epi8(lo, s))))
+                    | static_cast<std::uint64_t>(static_cast<unsigned>(
+                          _mm256_movemask_epi8(_mm256_cmpeq_epi8(hi, s))))
+                          << 32;
+                const auto count =
+                    static_cast<std::size_t>(__builtin_popcountll(mask));
+                if (count >= k) {
+                    return i + select_bit(mask, k);
+                }
+                k -= count;
+            }
+            const auto pos = find_nth_scalar(p + i, n - i, sep, k);
+            return pos == std::string_view::npos ? pos : i + pos;
+        }
+
+#endif
+
+        // warming up AVX2 costs more than it saves on short strings
+        constexpr std::size_t min_avx2_size = 256;
+
+        std::size_t find_nth(
+            std::string_view view, char sep, std::size_t& k) noexcept
+        {
+#if defined(STUFF_AVX2_DISPATCH)
+            // the AVX2 kernel counts separators with POPCNT too
+            if (core::detail::use_avx2(view.size(), min_avx2_size)
+                && core::detail::have_popcnt()) {
+                return find_nth_avx2(view.data(), view.size(), sep, k);
+            }
+#endif
+            return find_nth_baseline(view.data(), view.size(), sep, k);
+        }
+
+    } // namespace
+
+    string_separator::string_separator(std::string_view sep) : m_sep {sep}
+    {
+        if (m_sep.size() <= max_short_separator) {
+            return;
+        }
+
+        const auto m    = m_sep.size();
+        auto       skip = std::make_shared<skip_table>();
+        skip->fill(static_cast<std::uint8_t>(std::min<std::size_t>(m, 255)));
+        for (std::size_t i = 0; i + 1 < m; ++i) {
+            const auto shift = std::min<std::size_t>(m - 1 - i, 255);
+            (*skip)[static_cast<unsigned char>(m_sep[i])] =
+                static_cast<std::uint8_t>(shift);
+        }
+        m_skip = std::move(skip);
+    }
+
+    std::size_t string_separator::find(std::string_view view) const noexcept
+    {
+        switch (m_sep.size()) {
+            case 0:
+                return std::string_view::npos;
+            case 1:
+                return view.find(m_sep.front());
+            default:
+                if (m_sep.size() > view.size()) {
+                    return std::string_view::npos;
+                }
+                if (m_sep.size() <= max_short_separator) {
+                    return find_short(view, m_sep);
+                }
+                return find_long(view, m_sep, *m_skip);
+        }
+    }
+
     string_tokenizer::string_tokenizer(std::string_view view)
     : m_is_done {false}, m_tail {view}
     {
@@ -64,14 +288,104 @@ namespace stuff::string {
         return m_head;
     }
 
+    std::string_view string_tokenizer::next(const string_separator& sep)
+    {
+        if (m_is_done) {
+            m_head = std::string_view {};
+            return m_head;
+        }
+
+        auto pos = sep.find(m_tail);
+        if (pos == std::string_view::npos) {
+            m_is_done = true;
+            m_head    = m_tail;
+            m_tail    = std::string_view {};
+        }
+        else {
+            m_head = m_tail.substr(0, pos);
+            m_tail.remove_prefix(pos + sep.size());
+        }
+        return m_head;
+    }
+
+    std::size_t string_tokenizer::skip(std::size_t n, char sep)
+    {
+        m_head = std::string_view {};
+        if (m_is_done || n == 0) {
+            return 0;
+        }
+
+        auto remaining = n;
+        auto pos       = find_nth(m_tail, sep, remaining);
+        if (pos == std::string_view::npos) {
+            // the last token (after the last separator) was skipped too
+            m_is_done = true;
+            m_tail    = std::string_view {};
+            return n - remaining + 1;
+        }
+        m_tail.remove_prefix(pos + 1);
+        return n;
+    }
+
+    std::string_view string_tokenizer::field(std::size_t k, char sep)
+    {
+        if (skip(k, sep) < k) {
+            return m_head;
+        }
+        return next(sep);
+    }
+
+    namespace {
+
+        template <typename C>
+        inline void split_into(std::string_view view, char sep, C& result)
+        {
+            result.clear();
+            string_tokenizer stok {view};
+            do {
+                result.emplace_back(stok.next(sep));
+            } while (stok);
+        }
+
+    } // namespace
+
     container::string_view_array split_string(std::string_view view, char sep)
     {
         container::string_view_array result;
-        string_tokenizer             stok {view};
-        do {
-            result.emplace_back(stok.next(sep));
-        } while (stok);
+        split_into(view, sep, result);
         return result;
     }
 
+    void split_string(std::string_view view, char sep,
+        container::string_view_array& result)
+    {
+        split_into(view, sep, result);
+    }
+
+    void split_string(std::string_view view, char sep,
+        container::small_string_view_array& result)
+    {
+        split_into(view, sep, result);
+    }
+
+    std::string_view nth_field(
+        std::string_view view, char sep, std::size_t k) noexcept
+    {
+        // skip k separators without building the intermediate tokens
+        std::size_t start = 0;
+        if (k > 0) {
+            auto pos = find_nth(view, sep, k);
+            if (pos == std::string_view::npos) {
+                return std::string_view {};
+            }
+            start = pos + 1;
+        }
+
+        auto pos = view.find(sep, start);
+        if (pos == std::string_view::npos) {
+            return view.substr(start);
+        }
+        return view.substr(start, pos - start);
+    }
+
 } // namespace stuff::string
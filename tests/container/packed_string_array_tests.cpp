@@ -0,0 +1,151 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include <stuff/container/packed_string_array.h>
+
+using namespace stuff::container;
+
+TEST_CASE("packed_string_array", "[container]")
+{
+    packed_string_array array;
+
+    SECTION("an empty array")
+    {
+        REQUIRE(array.empty());
+        REQUIRE(array.size() == 0);
+        REQUIRE(array.bytes() == 0);
+        REQUIRE(array.begin() == array.end());
+        REQUIRE_THROWS_AS(array.at(0), std::out_of_range);
+    }
+
+    SECTION("adding strings")
+    {
+        array.push_back("one");
+        array.push_back("");
+        array.push_back(std::string {"three"});
+
+        REQUIRE(array.size() == 3);
+        REQUIRE(array.bytes() == 8);
+        REQUIRE(array[0] == "one");
+        REQUIRE(array[1].empty());
+        REQUIRE(array.at(2) == "three");
+        REQUIRE(array.front() == "one");
+        REQUIRE(array.back() == "three");
+        REQUIRE_THROWS_AS(array.at(3), std::out_of_range);
+
+        // the characters are stored back-to-back
+        REQUIRE(array[2].data() == array[0].data() + 3);
+    }
+
+    SECTION("iterating")
+    {
+        for (auto str : {"b", "c", "a"}) {
+            array.push_back(str);
+        }
+
+        std::string all;
+        for (auto view : array) {
+            all += view;
+        }
+        REQUIRE(all == "bca");
+        REQUIRE(array.end() - array.begin() == 3);
+        REQUIRE(*(array.begin() + 2) == "a");
+        REQUIRE(array.begin()[1] == "c");
+        REQUIRE(*std::min_element(array.begin(), array.end()) == "a");
+        auto it = std::find(array.begin(), array.end(), "c");
+        REQUIRE(it - array.begin() == 1);
+    }
+
+    SECTION("reserving and clearing")
+    {
+        array.reserve(100, 1000);
+        for (int i = 0; i < 100; ++i) {
+            array.push_back(std::to_string(i));
+        }
+        REQUIRE(array.size() == 100);
+        REQUIRE(array[42] == "42");
+
+        array.clear();
+        REQUIRE(array.empty());
+        array.push_back("again");
+        REQUIRE(array.size() == 1);
+        REQUIRE(array[0] == "again");
+    }
+
+    SECTION("moving")
+    {
+        array.push_back("one");
+        array.push_back("two");
+
+        packed_string_array moved {std::move(array)};
+        REQUIRE(moved.size() == 2);
+        REQUIRE(moved[1] == "two");
+
+        // a moved-from array is empty and can be used again
+        REQUIRE(array.empty());
+        REQUIRE(array.size() == 0);
+        REQUIRE(array.begin() == array.end());
+        array.push_back("three");
+        REQUIRE(array.size() == 1);
+        REQUIRE(array[0] == "three");
+
+        packed_string_array assigned;
+        assigned.push_back("four");
+        assigned = std::move(moved);
+        REQUIRE(assigned.size() == 2);
+        REQUIRE(assigned[0] == "one");
+        REQUIRE(moved.empty());
+        moved.clear();
+        moved.push_back("five");
+        REQUIRE(moved.size() == 1);
+        REQUIRE(moved[0] == "five");
+
+        // moves cannot throw, so a growing vector moves (not copies) arrays
+        static_assert(
+            std::is_nothrow_default_constructible_v<packed_string_array>);
+        static_assert(
+            std::is_nothrow_move_constructible_v<packed_string_array>);
+        static_assert(std::is_nothrow_move_assignable_v<packed_string_array>);
+        std::vector<packed_string_array> columns(1);
+        columns[0].push_back("six");
+        const char* chars = columns[0][0].data();
+        for (int i = 0; i < 100; ++i) {
+            columns.emplace_back();
+        }
+        REQUIRE(columns[0][0] == "six");
+        REQUIRE(columns[0][0].data() == chars);
+        REQUIRE(columns[1].empty());
+    }
+
+    SECTION("proxy iterator")
+    {
+        array.push_back("abc");
+        auto it = array.begin();
+        REQUIRE(it->size() == 3);
+        REQUIRE(std::is_same_v<
+            std::iterator_traits<packed_string_array::const_iterator>::
+                iterator_category,
+            std::input_iterator_tag>);
+    }
+}
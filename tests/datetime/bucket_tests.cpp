@@ -0,0 +1,321 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <date/date.h>
+#include <date/tz.h>
+#include <exception>
+#include <random>
+#include <stuff/datetime/bucket.h>
+#include <stuff/datetime/conversions.h>
+#include <vector>
+
+using namespace stuff::datetime;
+using namespace std::chrono_literals;
+
+// the bucket start of t the slow way (i.e., a floor division)
+sys_time floor_time(sys_time t, duration size, sys_time origin)
+{
+    auto n = (t - origin).count() / size.count();
+    if ((t - origin).count() % size.count() < 0) {
+        --n;
+    }
+    return origin + n * size;
+}
+
+TEST_CASE("Floor times to fixed size buckets", "[datetime]")
+{
+    // times from 1900 to 2100 (and some odd ones) in any order
+    std::mt19937_64                             random {42};
+    std::uniform_int_distribution<std::int64_t> between {
+        -2'208'988'800'000'000'000, 4'102'444'800'000'000'000};
+    std::vector<sys_time> times;
+    for (int k = 0; k < 1001; ++k) {
+        times.emplace_back(duration {between(random)});
+    }
+    times.emplace_back(duration {0});
+    times.emplace_back(duration {-1});
+    times.emplace_back(duration {1});
+
+    for (auto size : {duration {1}, duration {3}, duration {1s},
+             duration {333ms}, duration {1min}, duration {5min},
+             duration {1h}, duration {24h}, duration {168h},
+             duration {1'234'567'891}, duration {1'099'511'627'776}}) {
+        for (auto origin :
+            {sys_time {}, sys_time {2min + 7s}, sys_time {-1h}}) {
+            const auto starts  = floor_times(times, size, origin);
+            const auto indexes = bucket_indexes(times, size, origin);
+            REQUIRE(starts.size() == times.size());
+            REQUIRE(indexes.size() == times.size());
+            for (std::size_t k = 0; k < times.size(); ++k) {
+                const auto start = floor_time(times[k], size, origin);
+                REQUIRE(starts[k] == start);
+                REQUIRE(origin + indexes[k] * size == start);
+            }
+        }
+    }
+
+    // the same as date::floor
+    const auto seconds = floor_times(times, 1s);
+    const auto minutes = floor_times(times, 1min);
+    const auto days    = floor_times(times, 24h);
+    for (std::size_t k = 0; k < times.size(); ++k) {
+        REQUIRE(seconds[k] == date::floor<std::chrono::seconds>(times[k]));
+        REQUIRE(minutes[k] == date::floor<std::chrono::minutes>(times[k]));
+        REQUIRE(days[k] == date::floor<date::days>(times[k]));
+    }
+
+    REQUIRE_THROWS_AS(floor_times(times, duration {0}), datetime_error);
+    REQUIRE_THROWS_AS(bucket_indexes(times, -1s), datetime_error);
+}
+
+TEST_CASE("Floor times to calendar buckets", "[datetime]")
+{
+    const auto& zone = locate_fast_zone("America/New_York");
+    const auto  nyc  = [&](std::string_view view) {
+        return to_sys_time(view, zone.zone());
+    };
+
+    // around the start of daylight saving time (Sunday March 8, 2020)
+    const std::vector<sys_time> times {nyc("2020-02-29T23:59:59"),
+        nyc("2020-03-01T00:00:00"), nyc("2020-03-07T12:00:00"),
+        nyc("2020-03-08T01:59:59"), nyc("2020-03-08T03:00:00"),
+        nyc("2020-03-09T00:00:00"), nyc("2020-03-31T23:59:59"),
+        nyc("2020-04-01T00:00:00")};
+
+    REQUIRE(floor_times(times, calendar_interval::day, zone)
+            == std::vector<sys_time> {nyc("2020-02-29T00:00:00"),
+                nyc("2020-03-01T00:00:00"), nyc("2020-03-07T00:00:00"),
+                nyc("2020-03-08T00:00:00"), nyc("2020-03-08T00:00:00"),
+                nyc("2020-03-09T00:00:00"), nyc("2020-03-31T00:00:00"),
+                nyc("2020-04-01T00:00:00")});
+    REQUIRE(floor_times(times, calendar_interval::week, zone)
+            == std::vector<sys_time> {nyc("2020-02-23T00:00:00"),
+                nyc("2020-03-01T00:00:00"), nyc("2020-03-01T00:00:00"),
+                nyc("2020-03-08T00:00:00"), nyc("2020-03-08T00:00:00"),
+                nyc("2020-03-08T00:00:00"), nyc("2020-03-29T00:00:00"),
+                nyc("2020-03-29T00:00:00")});
+    REQUIRE(floor_times(times, calendar_interval::month, zone)
+            == std::vector<sys_time> {nyc("2020-02-01T00:00:00"),
+                nyc("2020-03-01T00:00:00"), nyc("2020-03-01T00:00:00"),
+                nyc("2020-03-01T00:00:00"), nyc("2020-03-01T00:00:00"),
+                nyc("2020-03-01T00:00:00"), nyc("2020-03-01T00:00:00"),
+                nyc("2020-04-01T00:00:00")});
+
+    // a local day is 23 hours when the clocks go forward
+    const auto days = floor_times(times, calendar_interval::day, zone);
+    REQUIRE(days[5] - days[4] == 23h);
+}
+
+TEST_CASE("Resample ticks to OHLCV bars", "[datetime]")
+{
+    const auto at = [](duration d) { return sys_time {d}; };
+
+    SECTION("fixed size")
+    {
+        ohlcv_resampler resampler {1min};
+        REQUIRE_FALSE(resampler.add(at(10s), 100.0, 1.0));
+        REQUIRE_FALSE(resampler.add(at(20s), 102.0, 2.0));
+        REQUIRE_FALSE(resampler.add(at(59s), 99.0, 3.0));
+        REQUIRE(resampler.current()->ticks == 3);
+
+        // no bar for the minute without ticks
+        const auto bar = resampler.add(at(2min + 1s), 101.0, 4.0);
+        REQUIRE(bar);
+        REQUIRE(bar->start == at(0min));
+        REQUIRE(bar->open == 100.0);
+        REQUIRE(bar->high == 102.0);
+        REQUIRE(bar->low == 99.0);
+        REQUIRE(bar->close == 99.0);
+        REQUIRE(bar->volume == 6.0);
+        REQUIRE(bar->ticks == 3);
+
+        REQUIRE_THROWS_AS(resampler.add(at(1min), 1.0, 1.0), datetime_error);
+
+        const auto last = resampler.flush();
+        REQUIRE(last);
+        REQUIRE(last->start == at(2min));
+        REQUIRE(last->open == 101.0);
+        REQUIRE(last->ticks == 1);
+        REQUIRE_FALSE(resampler.flush());
+    }
+
+    SECTION("many ticks at once")
+    {
+        // a tick every 7 seconds; the same bars one at a time or at once
+        std::vector<sys_time> times;
+        std::vector<double>   prices;
+        std::vector<double>   volumes;
+        for (int k = 0; k < 1000; ++k) {
+            times.push_back(at(k * 7s));
+            prices.push_back(100.0 + (k * 37) % 11);
+            volumes.push_back(k);
+        }
+
+        const auto same = [](const ohlcv_bar& a, const ohlcv_bar& b) {
+            return a.start == b.start && a.open == b.open && a.high == b.high
+                   && a.low == b.low && a.close == b.close
+                   && a.volume == b.volume && a.ticks == b.ticks;
+        };
+
+        ohlcv_resampler        one {5min, at(30s)};
+        std::vector<ohlcv_bar> expected;
+        for (std::size_t k = 0; k < times.size(); ++k) {
+            if (auto bar = one.add(times[k], prices[k], volumes[k])) {
+                expected.push_back(*bar);
+            }
+        }
+
+        ohlcv_resampler        all {5min, at(30s)};
+        std::vector<ohlcv_bar> bars;
+        all.add(times.data(), prices.data(), volumes.data(), times.size(),
+            [&](const ohlcv_bar& bar) { bars.push_back(bar); });
+
+        REQUIRE(expected.size() == 24);
+        REQUIRE(bars.size() == expected.size());
+        for (std::size_t k = 0; k < bars.size(); ++k) {
+            REQUIRE(same(bars[k], expected[k]));
+            REQUIRE(bars[k].start == at(30s + k * 5min) - 5min);
+        }
+        REQUIRE(same(*one.flush(), *all.flush()));
+    }
+
+    SECTION("many ticks, one out of order")
+    {
+        // bars of 0, 1 and 2 min, then a tick back in the 1 min bar
+        const std::vector<sys_time> times {at(10s), at(70s), at(80s),
+            at(130s), at(140s), at(90s), at(200s)};
+        const std::vector<double>   prices {1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0};
+        const std::vector<double>   volumes(times.size(), 1.0);
+
+        ohlcv_resampler        resampler {1min};
+        std::vector<ohlcv_bar> bars;
+        const auto on_bar = [&](const ohlcv_bar& bar) { bars.push_back(bar); };
+        REQUIRE_THROWS_AS(resampler.add(times.data(), prices.data(),
+                              volumes.data(), times.size(), on_bar),
+            datetime_error);
+
+        // the ticks before the one out of order are in the bars (once)
+        REQUIRE(bars.size() == 2);
+        REQUIRE(bars[1].start == at(1min));
+        REQUIRE(bars[1].ticks == 2);
+        const auto current = resampler.flush();
+        REQUIRE(current);
+        REQUIRE(current->start == at(2min));
+        REQUIRE(current->close == 5.0);
+        REQUIRE(current->ticks == 2);
+        REQUIRE_FALSE(resampler.flush());
+    }
+
+    SECTION("many ticks, on_bar throws")
+    {
+        const std::vector<sys_time> times {at(10s), at(70s), at(80s)};
+        const std::vector<double>   prices {1.0, 2.0, 3.0};
+        const std::vector<double>   volumes(times.size(), 1.0);
+
+        ohlcv_resampler resampler {1min};
+        const auto on_bar = [](const ohlcv_bar&) { throw std::exception {}; };
+        REQUIRE_THROWS_AS(resampler.add(times.data(), prices.data(),
+                              volumes.data(), times.size(), on_bar),
+            std::exception);
+
+        // the bar passed to on_bar() is done with; the tick after it is not
+        REQUIRE(resampler.current()->start == at(1min));
+        REQUIRE(resampler.current()->ticks == 1);
+        REQUIRE_FALSE(resampler.add(at(80s), 3.0, 1.0));
+        REQUIRE(resampler.flush()->ticks == 2);
+    }
+
+    SECTION("many ticks in batches, one out of order")
+    {
+        // a tick a second; the one in the second batch that would start the
+        // 5 min bar is back in the 1 min bar
+        std::vector<sys_time> times;
+        std::vector<double>   prices;
+        for (int k = 0; k < 400; ++k) {
+            times.push_back(at(k * 1s));
+            prices.push_back(k);
+        }
+        times[300] = at(90s);
+        const std::vector<double> volumes(times.size(), 1.0);
+
+        ohlcv_resampler        resampler {1min};
+        std::vector<ohlcv_bar> bars;
+        const auto on_bar = [&](const ohlcv_bar& bar) { bars.push_back(bar); };
+        REQUIRE_THROWS_AS(resampler.add(times.data(), prices.data(),
+                              volumes.data(), times.size(), on_bar),
+            datetime_error);
+
+        // the current bar has its ticks from both batches
+        REQUIRE(bars.size() == 4);
+        REQUIRE(bars[3].start == at(3min));
+        REQUIRE(bars[3].ticks == 60);
+        const auto current = resampler.flush();
+        REQUIRE(current);
+        REQUIRE(current->start == at(4min));
+        REQUIRE(current->open == 240.0);
+        REQUIRE(current->close == 299.0);
+        REQUIRE(current->ticks == 60);
+        REQUIRE_FALSE(resampler.flush());
+    }
+
+    SECTION("many ticks in batches, on_bar throws")
+    {
+        std::vector<sys_time> times;
+        for (int k = 0; k < 400; ++k) {
+            times.push_back(at(k * 1s));
+        }
+        const std::vector<double> prices(times.size(), 1.0);
+        const std::vector<double> volumes(times.size(), 1.0);
+
+        // the 4 min bar is done in the second batch
+        ohlcv_resampler        resampler {1min};
+        std::vector<ohlcv_bar> bars;
+        const auto             on_bar = [&](const ohlcv_bar& bar) {
+            if (bar.start == at(4min)) {
+                throw std::exception {};
+            }
+            bars.push_back(bar);
+        };
+        REQUIRE_THROWS_AS(resampler.add(times.data(), prices.data(),
+                              volumes.data(), times.size(), on_bar),
+            std::exception);
+
+        REQUIRE(bars.size() == 4);
+        REQUIRE(resampler.current()->start == at(5min));
+        REQUIRE(resampler.current()->ticks == 1);
+        REQUIRE_FALSE(resampler.add(at(301s), 1.0, 1.0));
+        REQUIRE(resampler.flush()->ticks == 2);
+    }
+
+    SECTION("calendar interval")
+    {
+        const auto& zone = locate_fast_zone("America/New_York");
+        const auto  nyc  = [&](std::string_view view) {
+            return to_sys_time(view, zone.zone());
+        };
+
+        ohlcv_resampler resampler {calendar_interval::day, zone};
+        REQUIRE_FALSE(resampler.add(nyc("2020-03-08T00:30:00"), 1.0, 1.0));
+        REQUIRE_FALSE(resampler.add(nyc("2020-03-08T23:59:59"), 2.0, 1.0));
+        const auto bar = resampler.add(nyc("2020-03-09T00:00:00"), 3.0, 1.0);
+        REQUIRE(bar);
+        REQUIRE(bar->start == nyc("2020-03-08T00:00:00"));
+        REQUIRE(bar->close == 2.0);
+        REQUIRE(bar->ticks == 2);
+    }
+}
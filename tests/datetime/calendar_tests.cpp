@@ -0,0 +1,186 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <date/date.h>
+#include <date/tz.h>
+#include <stuff/datetime/calendar.h>
+#include <stuff/datetime/conversions.h>
+
+using namespace stuff::datetime;
+using namespace std::chrono_literals;
+
+// a local time of a time zone as sys_time
+sys_time zone_time(const char* zone, std::string_view view)
+{
+    return to_sys_time(view, date::locate_zone(zone));
+}
+
+TEST_CASE("Trading calendar of a stock exchange", "[datetime]")
+{
+    const auto nyc = [](std::string_view view) {
+        return zone_time("America/New_York", view);
+    };
+
+    venue_rules rules {"XNYS", "America/New_York", {{9h + 30min, 16h}}};
+    rules.holidays.push_back(local_days {date::year {2020} / 7 / 3});
+    rules.early_closes.push_back(
+        {local_days {date::year {2020} / 11 / 27}, duration {13h}});
+    const trading_calendar nyse {rules, date::year {2020}, date::year {2020}};
+    REQUIRE(nyse.name() == "XNYS");
+
+    SECTION("open")
+    {
+        // local times whatever the offset (daylight saving time started on
+        // March 8)
+        REQUIRE_FALSE(nyse.is_open(nyc("2020-03-06T09:29:59")));
+        REQUIRE(nyse.is_open(nyc("2020-03-06T09:30:00")));
+        REQUIRE(nyse.is_open(nyc("2020-03-09T09:30:00")));
+        REQUIRE(nyse.is_open(nyc("2020-03-09T15:59:59")));
+        REQUIRE_FALSE(nyse.is_open(nyc("2020-03-09T16:00:00")));
+
+        // weekends, holidays and half days
+        REQUIRE_FALSE(nyse.is_open(nyc("2020-03-07T12:00:00")));
+        REQUIRE_FALSE(nyse.is_open(nyc("2020-07-03T12:00:00")));
+        REQUIRE(nyse.is_open(nyc("2020-11-27T12:59:59")));
+        REQUIRE_FALSE(nyse.is_open(nyc("2020-11-27T13:00:00")));
+
+        const auto session = nyse.session_of(nyc("2020-11-27T10:00:00"));
+        REQUIRE(session);
+        REQUIRE(session->open == nyc("2020-11-27T09:30:00"));
+        REQUIRE(session->close == nyc("2020-11-27T13:00:00"));
+        REQUIRE_FALSE(nyse.session_of(nyc("2020-11-27T14:00:00")));
+    }
+
+    SECTION("next open")
+    {
+        REQUIRE(nyse.next_open(nyc("2020-03-06T16:30:00"))
+                == nyc("2020-03-09T09:30:00"));
+        REQUIRE(nyse.next_open(nyc("2020-03-09T09:30:00"))
+                == nyc("2020-03-10T09:30:00"));
+        REQUIRE(nyse.next_open(nyc("2020-07-02T16:00:00"))
+                == nyc("2020-07-06T09:30:00"));
+        REQUIRE_THROWS_AS(
+            nyse.next_open(nyc("2020-12-31T17:00:00")), datetime_error);
+    }
+
+    SECTION("trading time between times")
+    {
+        const auto monday = nyc("2020-03-09T09:00:00");
+        const auto friday = nyc("2020-03-10T10:00:00");
+        REQUIRE(nyse.duration_between(monday, friday) == 7h);
+        REQUIRE(nyse.duration_between(friday, monday) == -7h);
+        REQUIRE(nyse.duration_between(monday, monday) == 0h);
+        REQUIRE(nyse.duration_between(nyc("2020-03-09T00:00:00"),
+                    nyc("2020-03-14T00:00:00"))
+                == 5 * (6h + 30min));
+        REQUIRE(nyse.duration_between(nyc("2020-07-02T16:00:00"),
+                    nyc("2020-07-06T09:30:00"))
+                == 0h);
+    }
+
+    SECTION("classify times")
+    {
+        std::vector<sys_time> times;
+        const auto end = nyc("2020-12-30T00:00:00");
+        for (auto t = nyc("2020-01-02T00:00:00"); t < end; t += 7min) {
+            times.push_back(t);
+        }
+        auto open = nyse.classify(times);
+        for (std::size_t i = 0; i < times.size(); ++i) {
+            REQUIRE(open[i] == nyse.is_open(times[i]));
+        }
+
+        std::reverse(times.begin(), times.end());
+        open = nyse.classify(times);
+        for (std::size_t i = 0; i < times.size(); ++i) {
+            REQUIRE(open[i] == nyse.is_open(times[i]));
+        }
+    }
+
+    SECTION("outside the calendar")
+    {
+        const auto before = nyc("2019-12-31T12:00:00");
+        REQUIRE_THROWS_AS(nyse.is_open(before), datetime_error);
+        REQUIRE_THROWS_AS(
+            nyse.duration_between(before, nyc("2020-03-09T09:00:00")),
+            datetime_error);
+
+        bool open[1];
+        REQUIRE_THROWS_AS(nyse.classify(&before, 1, open), datetime_error);
+    }
+}
+
+TEST_CASE("Trading calendar with a lunch break", "[datetime]")
+{
+    const auto tokyo = [](std::string_view view) {
+        return zone_time("Asia/Tokyo", view);
+    };
+
+    const trading_calendar tse {
+        {"XTKS", "Asia/Tokyo", {{9h, 11h + 30min}, {12h + 30min, 15h}}},
+        date::year {2020}, date::year {2020}};
+    REQUIRE(tse.is_open(tokyo("2020-06-01T11:29:59")));
+    REQUIRE_FALSE(tse.is_open(tokyo("2020-06-01T12:00:00")));
+    REQUIRE(tse.is_open(tokyo("2020-06-01T12:30:00")));
+    REQUIRE(tse.next_open(tokyo("2020-06-01T11:45:00"))
+            == tokyo("2020-06-01T12:30:00"));
+    REQUIRE(tse.duration_between(tokyo("2020-06-01T00:00:00"),
+                tokyo("2020-06-02T00:00:00"))
+            == 5h);
+}
+
+TEST_CASE("Trading calendar of overnight sessions", "[datetime]")
+{
+    const auto chicago = [](std::string_view view) {
+        return zone_time("America/Chicago", view);
+    };
+
+    // 5:00 PM the day before to 4:00 PM
+    const trading_calendar cme {{"XCME", "America/Chicago", {{-7h, 16h}}},
+        date::year {2020}, date::year {2020}};
+    REQUIRE_FALSE(cme.is_open(chicago("2020-06-07T16:59:59")));
+    REQUIRE(cme.is_open(chicago("2020-06-07T17:00:00")));
+    REQUIRE(cme.is_open(chicago("2020-06-08T15:59:59")));
+    REQUIRE_FALSE(cme.is_open(chicago("2020-06-08T16:30:00")));
+    REQUIRE(cme.is_open(chicago("2020-06-08T17:00:00")));
+    REQUIRE_FALSE(cme.is_open(chicago("2020-06-12T16:00:00")));
+    REQUIRE_FALSE(cme.is_open(chicago("2020-06-12T17:00:00")));
+    REQUIRE(cme.next_open(chicago("2020-06-12T16:00:00"))
+            == chicago("2020-06-14T17:00:00"));
+    REQUIRE(cme.duration_between(chicago("2020-06-07T00:00:00"),
+                chicago("2020-06-14T00:00:00"))
+            == 5 * 23h);
+}
+
+TEST_CASE("Trading calendar with bad rules", "[datetime]")
+{
+    const auto year = date::year {2020};
+    REQUIRE_THROWS_AS(trading_calendar({"X", "America/New_York", {}}, year,
+                          year),
+        datetime_error);
+    REQUIRE_THROWS_AS(trading_calendar({"X", "America/New_York", {{16h, 9h}}},
+                          year, year),
+        datetime_error);
+    REQUIRE_THROWS_AS(trading_calendar({"X", "Nowhere/Special", {{9h, 16h}}},
+                          year, year),
+        datetime_error);
+    REQUIRE_THROWS_AS(trading_calendar({"X", "America/New_York", {{9h, 16h}}},
+                          year, year - date::years {1}),
+        datetime_error);
+}
@@ -17,9 +17,11 @@
 
 #include <catch2/catch.hpp>
 #include <date/date.h>
+#include <fmt/format.h>
 #include <sstream>
 #include <stuff/datetime/conversions.h>
 #include <stuff/datetime/datetime.h>
+#include <utility>
 
 using namespace stuff::datetime;
 
@@ -39,6 +41,18 @@ local_time parse_local_date(std::string view)
     return tp;
 }
 
+std::string format_sys_date(sys_time t)
+{
+    auto dp  = date::floor<date::days>(t);
+    auto ymd = date::year_month_day(dp);
+    auto tod = date::make_time(t - dp);
+    return fmt::format("{}-{:02d}-{:02d}T{:02d}:{:02d}:{:02d}.{:09d}Z",
+        static_cast<int>(ymd.year()), static_cast<unsigned>(ymd.month()),
+        static_cast<unsigned>(ymd.day()), tod.hours().count(),
+        tod.minutes().count(), tod.seconds().count(),
+        tod.subseconds().count());
+}
+
 
 TEST_CASE("conversion helpers", "[datetime]")
 {
@@ -158,3 +172,233 @@ TEST_CASE("Convert a time to a string", "[datetime]")
                 nyc_tz(), to_local_time("2015-03-14T15:09:26.535897932")))
             == "2015-03-14T15:09:26.535897932 America/New_York");
 }
+
+TEST_CASE("Format a time without allocating", "[datetime]")
+{
+    char buf[sys_time_size + 1] {};
+
+    auto t = parse_sys_date("1969-12-31T23:59:59.999999999");
+    for (int i = 0; i < 10000; ++i) {
+        REQUIRE(format_to(buf, t) == buf + sys_time_size);
+        REQUIRE(std::string {buf} == format_sys_date(t));
+        t += std::chrono::hours {31} + std::chrono::nanoseconds {1234567};
+    }
+
+    // the whole range of nanosecond times (literals, as date::format() of
+    // sys_time::min() overflows: its day starts before sys_time::min())
+    const std::pair<sys_time, std::string_view> extremes[] {
+        {sys_time::min(), "1677-09-21T00:12:43.145224192Z"},
+        {sys_time::max(), "2262-04-11T23:47:16.854775807Z"}};
+    for (const auto& [extreme, str] : extremes) {
+        REQUIRE(format_to(buf, extreme) == buf + sys_time_size);
+        REQUIRE(std::string_view {buf, sys_time_size} == str);
+        REQUIRE(to_sys_time(str) == extreme);
+    }
+
+    auto local = to_local_time("2015-03-14T15:09:26.000000007");
+    REQUIRE(format_to(buf, local) == buf + local_time_size);
+    REQUIRE(std::string_view {buf, local_time_size}
+            == "2015-03-14T15:09:26.000000007");
+
+    // many times, several a day
+    std::vector<sys_time> times;
+    t = parse_sys_date("2015-03-14T00:00:00");
+    for (int i = 0; i < 100; ++i) {
+        times.push_back(t);
+        t += std::chrono::minutes {317};
+    }
+    std::string column(times.size() * sys_time_size, ' ');
+    REQUIRE(format_to(column.data(), times.data(), times.size())
+            == column.data() + column.size());
+    for (std::size_t i = 0; i < times.size(); ++i) {
+        REQUIRE(column.substr(i * sys_time_size, sys_time_size)
+                == to_string(times[i]));
+    }
+
+    std::vector<sys_time> parsed(times.size());
+    to_sys_times(column.data(), sys_time_size, sys_time_size, parsed.size(),
+        parsed.data());
+    REQUIRE(parsed == times);
+}
+
+TEST_CASE("Convert sorted times with a converter", "[datetime]")
+{
+    time_converter converter;
+
+    // several times a day, then a few out of order
+    auto t = parse_sys_date("1969-12-30T00:00:00");
+    for (int i = 0; i < 2000; ++i) {
+        const auto str = to_string(t);
+        REQUIRE(converter.to_string(t) == str);
+        REQUIRE(converter.to_sys_time(str) == t);
+
+        auto without_z = str.substr(0, str.size() - 1);
+        REQUIRE(converter.to_sys_time(without_z) == t);
+        t += std::chrono::minutes {97} + std::chrono::nanoseconds {13};
+    }
+    for (auto str : {"2015-03-14T15:09:26.535897932Z", "1970-01-01T00:00:00Z",
+             "2015-03-14 15:09:26Z", "2015-03-14T15:09:26.535Z",
+             "1970-01-01T00:00:01.000000001Z"}) {
+        REQUIRE(converter.to_sys_time(str) == to_sys_time(str));
+        REQUIRE(converter.to_string(to_sys_time(str))
+                == to_string(to_sys_time(str)));
+    }
+
+    // the date is kept, but the time of day must still be valid
+    REQUIRE(converter.try_to_sys_time("2015-03-14T15:09:26Z"));
+    REQUIRE_FALSE(converter.try_to_sys_time("2015-03-14T15:09:2xZ"));
+    REQUIRE_FALSE(converter.try_to_sys_time("2015-03-1xT15:09:26Z"));
+    REQUIRE_THROWS_AS(
+        converter.to_sys_time("2015-03-14X15:09:26Z"), datetime_error);
+
+    char buf[sys_time_size] {};
+    REQUIRE(converter.format_to(buf, sys_time {}) == buf + sys_time_size);
+    REQUIRE(std::string_view {buf, sys_time_size}
+            == "1970-01-01T00:00:00.000000000Z");
+}
+
+TEST_CASE("Convert a string to a time without throwing", "[datetime]")
+{
+    auto sys = try_to_sys_time("2015-03-14T15:09:26.535897932Z");
+    REQUIRE(sys);
+    REQUIRE(sys.value == parse_sys_date("2015-03-14T15:09:26.535897932Z"));
+
+    auto local = try_to_local_time("2015-03-14 15:09:26.5");
+    REQUIRE(local);
+    REQUIRE(local.value == parse_local_date("2015-03-14T15:09:26.5"));
+
+    // Check error path
+    REQUIRE_FALSE(try_to_sys_time("201q-03-14T15:09:26.535897932Z"));
+    REQUIRE_FALSE(try_to_sys_time("2015-03-14T15:09:26.5358979321Z"));
+    REQUIRE(try_to_sys_time("").ec == std::errc::invalid_argument);
+    REQUIRE_FALSE(try_to_local_time("201q-03-14T15:09:26.535897932"));
+    REQUIRE_FALSE(try_to_local_time("2015-03-14T15:09:26.5358979321q"));
+}
+
+TEST_CASE("Convert fixed-layout strings to time", "[datetime]")
+{
+    // the fixed layouts round trip through to_string() (on either side of
+    // the epoch, across leap days, etc.)
+    auto t = parse_sys_date("1899-12-31T23:59:59.999999999");
+    for (int i = 0; i < 10000; ++i) {
+        REQUIRE(to_sys_time(to_string(t)) == t);
+
+        auto str = to_string(t);
+        str.pop_back(); // without 'Z'
+        REQUIRE(to_sys_time(str) == t);
+        REQUIRE(to_local_time(str).time_since_epoch() == t.time_since_epoch());
+
+        t += std::chrono::hours {24 * 7 + 1} + std::chrono::nanoseconds {7};
+    }
+    REQUIRE(to_sys_time("2016-02-29T00:00:00Z")
+            == parse_sys_date("2016-02-29T00:00:00"));
+    REQUIRE(to_sys_time("2016-02-29 23:59:59.000000001")
+            == parse_sys_date("2016-02-29T23:59:59.000000001"));
+
+    // the fixed layout with anything out of place
+    REQUIRE_FALSE(try_to_sys_time("2015-03-14T15:09:26.53589793xZ"));
+    REQUIRE_FALSE(try_to_sys_time("2015-03-14T15:09:26,535897932Z"));
+    REQUIRE_FALSE(try_to_sys_time("2015/03/14T15:09:26.535897932Z"));
+    REQUIRE_FALSE(try_to_sys_time("2015-03-14X15:09:26Z"));
+    REQUIRE_FALSE(try_to_sys_time("2015-03-14T15-09:26Z"));
+    REQUIRE_FALSE(try_to_sys_time("2015-0:-14T15:09:26Z"));
+    REQUIRE_FALSE(try_to_sys_time("2015-03-14T15:09:2/Z"));
+    REQUIRE_FALSE(try_to_local_time("2015-03-14T15:09:26.535897932Z"));
+
+    // sys_time holds only part of its first and last days
+    REQUIRE(to_sys_time("1677-09-21T00:12:43.145224192Z") == sys_time::min());
+    REQUIRE(to_sys_time("2262-04-11T23:47:16.854775807Z") == sys_time::max());
+    REQUIRE(to_local_time("1677-09-21T00:12:43.145224192").time_since_epoch()
+            == sys_time::min().time_since_epoch());
+    for (auto str : {"1677-09-21T00:00:00Z", "1677-09-21T00:12:43.145224191Z",
+             "2262-04-11T23:47:16.854775808Z", "2262-04-12T00:00:00Z",
+             "9999-12-31T23:59:59.999999999Z", "1677-09-21T00:00:00.5Z",
+             "2015-03-14T9999999999999999:00:00Z"}) {
+        REQUIRE(try_to_sys_time(str).ec == std::errc::invalid_argument);
+        REQUIRE_FALSE(time_converter {}.try_to_sys_time(str));
+        std::string local {str};
+        local.pop_back(); // without 'Z'
+        REQUIRE_FALSE(try_to_local_time(local));
+    }
+
+    // the same with AVX2 (if there is, for 16 or more strings)
+    std::vector<std::string_view> views(20, "2262-04-11T23:47:16.854775807Z");
+    views[3] = "1677-09-21T00:12:43.145224192";
+    REQUIRE(to_sys_times(views)[3] == sys_time::min());
+    views[7] = "2262-04-11T23:47:16.854775808";
+    REQUIRE_THROWS_AS(to_sys_times(views), datetime_error);
+}
+
+TEST_CASE("Convert many strings to times", "[datetime]")
+{
+    // mostly the usual layout, but some are not
+    std::vector<std::string> strs;
+    auto t = parse_sys_date("1969-12-31T23:59:59.999999999");
+    for (int i = 0; i < 1000; ++i) {
+        strs.push_back(to_string(t));
+        t += std::chrono::hours {25} + std::chrono::nanoseconds {12345};
+    }
+    strs[10] = "2015-03-14 15:09:26.535897932Z";
+    strs[11] = "2015-03-14T15:09:26.535897932";
+    strs[12] = "2015-03-14T15:09:26.535Z";
+    strs[13] = "2015-03-14T15:09:26";
+
+    std::vector<std::string_view> views {strs.begin(), strs.end()};
+    auto                          times = to_sys_times(views);
+    REQUIRE(times.size() == strs.size());
+    for (std::size_t i = 0; i < strs.size(); ++i) {
+        REQUIRE(times[i] == to_sys_time(strs[i]));
+    }
+
+    // the first invalid string is reported
+    views[500] = "2015-03-14T15:09:26.5358979x2Z";
+    views[600] = "2015-03-14T15:09:26.535897932X";
+    REQUIRE_THROWS_WITH(to_sys_times(views),
+        Catch::Contains("2015-03-14T15:09:26.5358979x2Z"));
+
+    // strided (i.e., "{time},{price}\n")
+    std::string column;
+    for (std::size_t i = 0; i < 100; ++i) {
+        column += strs[100 + i * 3] + ",1.08231\n";
+    }
+    std::vector<sys_time> strided(100);
+    to_sys_times(column.data(), 30, 39, strided.size(), strided.data());
+    for (std::size_t i = 0; i < strided.size(); ++i) {
+        REQUIRE(strided[i] == to_sys_time(strs[100 + i * 3]));
+    }
+}
+
+TEST_CASE("Convert many strings to times in parallel", "[datetime]")
+{
+    std::vector<std::string_view> views(300000);
+    for (std::size_t i = 0; i < views.size(); ++i) {
+        views[i] = i % 2 == 0 ? "2015-03-14T15:09:26.535897932Z"
+                              : "2020-03-21 09:34:51.123";
+    }
+    std::vector<sys_time> times(views.size());
+    to_sys_times(views.data(), views.size(), times.data(), 4);
+    REQUIRE(times.front() == to_sys_time(views[0]));
+    REQUIRE(times.back() == to_sys_time(views[1]));
+    REQUIRE(to_sys_times(views, 0) == times);
+
+    views[250000] = "junk";
+    REQUIRE_THROWS_AS(to_sys_times(views, 4), datetime_error);
+}
+
+TEST_CASE("Parse a record with a time", "[datetime]")
+{
+    using record = std::tuple<sys_time, std::string_view, double>;
+
+    auto result = stuff::string::parse_record<record>(
+        "2015-03-14T15:09:26.535897932Z,EUR/USD,1.08231", ',');
+    REQUIRE(result);
+    REQUIRE(std::get<0>(result.value)
+            == parse_sys_date("2015-03-14T15:09:26.535897932Z"));
+    REQUIRE(std::get<1>(result.value) == "EUR/USD");
+    REQUIRE(std::get<2>(result.value) == 1.08231);
+
+    auto bad = stuff::string::parse_record<record>(
+        "2015-03-14T15:09:2x.535897932Z,EUR/USD,1.08231", ',');
+    REQUIRE(bad.ec == std::errc::invalid_argument);
+    REQUIRE(bad.field == 0);
+}
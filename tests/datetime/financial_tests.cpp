@@ -0,0 +1,136 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <date/date.h>
+#include <sstream>
+#include <stuff/datetime/conversions.h>
+#include <stuff/datetime/datetime.h>
+#include <stuff/datetime/financial.h>
+
+using namespace stuff::datetime;
+
+// a New York local time as sys_time
+sys_time nyc_time(std::string_view view)
+{
+    return to_sys_time(view, nyc_tz());
+}
+
+TEST_CASE("Forex calendar without closures", "[datetime]")
+{
+    const forex_calendar calendar {date::year {2019}, date::year {2020}};
+
+    // every 37 minutes (and past the range)
+    const auto begin = sys_time {date::sys_days {date::year {2018} / 12 / 1}};
+    const auto end   = sys_time {date::sys_days {date::year {2021} / 2 / 1}};
+    std::vector<sys_time> times;
+    for (auto t = begin; t < end; t += std::chrono::minutes(37)) {
+        const auto bells = get_forex_bells(t);
+        const bool open  = t >= bells.open && t < bells.close;
+        REQUIRE(calendar.is_open(t) == open);
+
+        const auto session = calendar.session_of(t);
+        REQUIRE(session.has_value() == open);
+        if (session) {
+            REQUIRE(session->open == bells.open);
+            REQUIRE(session->close == bells.close);
+        }
+        times.push_back(t);
+    }
+
+    const auto open = calendar.classify(times);
+    for (std::size_t i = 0; i < times.size(); ++i) {
+        REQUIRE(open[i] == calendar.is_open(times[i]));
+    }
+}
+
+TEST_CASE("Forex calendar with closures", "[datetime]")
+{
+    std::istringstream in {"# holidays\n"
+                           "2019-12-25\r\n"
+                           "\n"
+                           "2019-12-31T13:00:00   2019-12-31T17:00:00\n"
+                           "2020-01-01\n"};
+    const auto closures = read_forex_closures(in);
+    REQUIRE(closures.size() == 3);
+    REQUIRE(closures[0].from == nyc_time("2019-12-24T17:00:00"));
+    REQUIRE(closures[0].to == nyc_time("2019-12-25T17:00:00"));
+
+    const forex_calendar calendar {date::year {2019}, date::year {2020},
+        closures};
+
+    SECTION("closed for the holidays")
+    {
+        REQUIRE(calendar.is_open(nyc_time("2019-12-24T16:59:59")));
+        REQUIRE_FALSE(calendar.is_open(nyc_time("2019-12-24T17:00:00")));
+        REQUIRE_FALSE(calendar.is_open(nyc_time("2019-12-25T12:00:00")));
+        REQUIRE(calendar.is_open(nyc_time("2019-12-25T17:00:00")));
+
+        // the closures from 1:00 PM to 5:00 PM the next day are merged
+        REQUIRE(calendar.is_open(nyc_time("2019-12-31T12:59:59")));
+        REQUIRE_FALSE(calendar.is_open(nyc_time("2019-12-31T13:00:00")));
+        REQUIRE_FALSE(calendar.is_open(nyc_time("2020-01-01T12:00:00")));
+        REQUIRE(calendar.is_open(nyc_time("2020-01-01T17:00:00")));
+    }
+
+    SECTION("sessions are split by closures")
+    {
+        const auto before =
+            calendar.session_of(nyc_time("2019-12-23T00:00:00"));
+        REQUIRE(before);
+        REQUIRE(before->open == nyc_time("2019-12-22T17:00:00"));
+        REQUIRE(before->close == nyc_time("2019-12-24T17:00:00"));
+
+        const auto after =
+            calendar.session_of(nyc_time("2019-12-25T18:00:00"));
+        REQUIRE(after);
+        REQUIRE(after->open == nyc_time("2019-12-25T17:00:00"));
+        REQUIRE(after->close == nyc_time("2019-12-27T17:00:00"));
+
+        REQUIRE_FALSE(calendar.session_of(nyc_time("2019-12-25T00:00:00")));
+    }
+
+    SECTION("classify unsorted times")
+    {
+        std::vector<sys_time> times {nyc_time("2020-01-06T00:00:00"),
+            nyc_time("2019-12-25T00:00:00"), nyc_time("2019-12-22T00:00:00"),
+            nyc_time("2019-12-26T00:00:00"), nyc_time("2030-01-02T00:00:00"),
+            nyc_time("2019-12-25T18:00:00")};
+        bool open[6];
+        calendar.classify(times.data(), times.size(), open);
+        for (std::size_t i = 0; i < times.size(); ++i) {
+            REQUIRE(open[i] == calendar.is_open(times[i]));
+        }
+        REQUIRE(open[0]);
+        REQUIRE_FALSE(open[1]);
+        REQUIRE(open[4]);
+    }
+}
+
+TEST_CASE("Read bad forex closures", "[datetime]")
+{
+    const auto read = [](const std::string& text) {
+        std::istringstream in {text};
+        return read_forex_closures(in);
+    };
+    REQUIRE_THROWS_AS(read("2020-12-25\nChristmas\n"), datetime_error);
+    REQUIRE_THROWS_AS(
+        read("2020-12-25T17:00:00 2020-12-25T13:00:00\n"), datetime_error);
+    REQUIRE_THROWS_AS(read_forex_closures("/no/such/file"), datetime_error);
+    REQUIRE_THROWS_AS(
+        forex_calendar(date::year {2021}, date::year {2020}), datetime_error);
+}
@@ -0,0 +1,210 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <date/date.h>
+#include <date/tz.h>
+#include <stuff/datetime/datetime.h>
+#include <stuff/datetime/financial.h>
+#include <stuff/datetime/zone.h>
+
+using namespace stuff::datetime;
+
+// a TZif file (version 2) with no transitions, just the offset and footer
+std::string make_tzif(std::int32_t offset, std::string_view footer)
+{
+    const auto append_int = [](std::string& s, std::int32_t n) {
+        for (int shift = 24; shift >= 0; shift -= 8) {
+            s += static_cast<char>((n >> shift) & 0xFF);
+        }
+    };
+
+    // header (1 type, 4 characters) and data: the same for 32 and 64 bits
+    std::string block {"TZif2"};
+    block.append(15, '\0');
+    for (std::int32_t count : {0, 0, 0, 0, 1, 4}) {
+        append_int(block, count);
+    }
+    append_int(block, offset);
+    block += std::string_view {"\0\0STD\0", 6};
+
+    return block + block + '\n' + std::string {footer} + '\n';
+}
+
+// every 15 minutes, in UTC and local time, against the time zone itself
+void check_zone(const fast_zone& zone, date::year first, date::year last)
+{
+    const auto tz    = zone.zone();
+    const auto begin = date::sys_days {first / date::January / 1};
+    const auto end   = date::sys_days {last / date::December / 31};
+    for (auto t = sys_time {begin}; t < end; t += std::chrono::minutes(15)) {
+        REQUIRE(zone.offset(t) == tz->get_info(t).offset);
+        REQUIRE(zone.to_local(t) == tz->to_local(t));
+
+        const local_time local {t.time_since_epoch()};
+        const auto       info = tz->get_info(local);
+        if (info.result == date::local_info::unique) {
+            REQUIRE(zone.to_sys(local) == tz->to_sys(local));
+            REQUIRE(zone.try_to_sys(local) == tz->to_sys(local));
+            continue;
+        }
+        REQUIRE_THROWS_AS(zone.to_sys(local), datetime_error);
+        REQUIRE_FALSE(zone.try_to_sys(local));
+        REQUIRE(zone.to_sys(local, local_policy::earliest)
+                == tz->to_sys(local, date::choose::earliest));
+        REQUIRE(zone.to_sys(local, local_policy::latest)
+                == tz->to_sys(local, date::choose::latest));
+    }
+}
+
+TEST_CASE("Precompute offsets of a time zone", "[datetime]")
+{
+    using date::year;
+
+    SECTION("match the time zone")
+    {
+        check_zone(nyc_fast_zone(), year {2019}, year {2021});
+
+        const fast_zone london {
+            date::locate_zone("Europe/London"), year {2019}, year {2021}};
+        check_zone(london, year {2019}, year {2021});
+    }
+
+    SECTION("match the time zone outside the range")
+    {
+        const fast_zone nyc {nyc_tz(), year {2020}, year {2020}};
+        check_zone(nyc, year {2018}, year {2022});
+    }
+
+    SECTION("local times that happen twice or never")
+    {
+        using namespace std::chrono_literals;
+
+        const auto& nyc = nyc_fast_zone();
+
+        // the clocks went forward at 2am (to 3am)
+        const auto       march  = year {2020} / 3 / 8;
+        const local_time never  = date::local_days {march} + 2h + 30min;
+        const sys_time   spring = date::sys_days {march} + 7h;
+        REQUIRE_THROWS_AS(nyc.to_sys(never), datetime_error);
+        REQUIRE_FALSE(nyc.try_to_sys(never));
+        REQUIRE(nyc.to_sys(never, local_policy::earliest) == spring);
+        REQUIRE(nyc.to_sys(never, local_policy::latest) == spring);
+
+        // the clocks went back at 2am (to 1am)
+        const auto       november = year {2020} / 11 / 1;
+        const local_time twice    = date::local_days {november} + 1h + 30min;
+        const sys_time   edt      = date::sys_days {november} + 5h + 30min;
+        REQUIRE_THROWS_AS(nyc.to_sys(twice), datetime_error);
+        REQUIRE_FALSE(nyc.try_to_sys(twice));
+        REQUIRE(nyc.to_sys(twice, local_policy::earliest) == edt);
+        REQUIRE(nyc.to_sys(twice, local_policy::latest) == edt + 1h);
+    }
+
+    SECTION("bad arguments")
+    {
+        REQUIRE_THROWS_AS(fast_zone(nullptr, year {2020}, year {2020}),
+            datetime_error);
+        REQUIRE_THROWS_AS(fast_zone(nyc_tz(), year {2021}, year {2020}),
+            datetime_error);
+    }
+}
+
+TEST_CASE("Read a time zone from a TZif file", "[datetime]")
+{
+    using date::year;
+    using namespace std::chrono_literals;
+
+    SECTION("the rule at the end of the file")
+    {
+        const fast_zone nyc {"America/New_York",
+            make_tzif(-5 * 3600, "EST5EDT,M3.2.0,M11.1.0"), year {2019},
+            year {2021}};
+        REQUIRE(nyc.name() == "America/New_York");
+        check_zone(nyc, year {2019}, year {2021});
+    }
+
+    SECTION("daylight saving time across the new year")
+    {
+        const fast_zone sydney {"Australia/Sydney",
+            make_tzif(10 * 3600, "AEST-10AEDT,M10.1.0,M4.1.0/3"), year {2020},
+            year {2020}};
+        const auto january = date::sys_days {year {2020} / 1 / 15};
+        const auto july    = date::sys_days {year {2020} / 7 / 15};
+        REQUIRE(sydney.offset(sys_time {january}) == 11h);
+        REQUIRE(sydney.offset(sys_time {july}) == 10h);
+
+        // the clocks went back at 3am on April 5
+        const auto april = date::local_days {year {2020} / 4 / 5};
+        REQUIRE_FALSE(sydney.try_to_sys(april + 2h + 30min));
+        REQUIRE(sydney.try_to_sys(april + 3h));
+    }
+
+    SECTION("no daylight saving time")
+    {
+        const fast_zone tokyo {"Asia/Tokyo", make_tzif(9 * 3600, "JST-9"),
+            year {2020}, year {2020}};
+        const auto t = sys_time {date::sys_days {year {2020} / 6 / 1}};
+        REQUIRE(tokyo.offset(t) == 9h);
+        REQUIRE(tokyo.to_sys(tokyo.to_local(t)) == t);
+    }
+
+    SECTION("bad files")
+    {
+        REQUIRE_THROWS_AS(
+            fast_zone("UTC", "TZif", year {2020}, year {2020}), datetime_error);
+        REQUIRE_THROWS_AS(fast_zone("UTC", make_tzif(0, "UTC0,M3"),
+                              year {2020}, year {2020}),
+            datetime_error);
+
+        auto tzif = make_tzif(0, "UTC0");
+        tzif[0]   = 'X';
+        REQUIRE_THROWS_AS(
+            fast_zone("UTC", tzif, year {2020}, year {2020}), datetime_error);
+    }
+}
+
+TEST_CASE("Locate a fast zone by name", "[datetime]")
+{
+    REQUIRE(&locate_fast_zone("America/New_York") == &nyc_fast_zone());
+    REQUIRE(nyc_fast_zone().name() == "America/New_York");
+    REQUIRE(locate_fast_zone("Europe/London").name() == "Europe/London");
+    REQUIRE_THROWS_AS(locate_fast_zone("Nowhere/Special"), datetime_error);
+
+    // the compiled in time zones (if any) are sorted
+    const auto [zones, size] = detail::embedded_zones();
+    for (std::size_t i = 1; i < size; ++i) {
+        REQUIRE(std::string_view {zones[i - 1].name} < zones[i].name);
+    }
+}
+
+TEST_CASE("Forex bells in New York", "[datetime]")
+{
+    const auto begin = date::sys_days {date::year {2019} / 1 / 1};
+    const auto end   = date::sys_days {date::year {2021} / 1 / 1};
+    for (auto t = sys_time {begin}; t < end; t += std::chrono::hours(5)) {
+        // the same as with the time zone
+        zoned_time sunday = find_sunday(date::make_zoned(nyc_tz(), t));
+        local_time open   = sunday.get_local_time() + std::chrono::hours(17);
+        local_time close  = open + date::days(5);
+
+        const auto bells = get_forex_bells(t);
+        REQUIRE(bells.open == date::make_zoned(nyc_tz(), open).get_sys_time());
+        REQUIRE(bells.close
+                == date::make_zoned(nyc_tz(), close).get_sys_time());
+    }
+}
@@ -16,6 +16,8 @@
 //
 
 #include <catch2/catch.hpp>
+#include <fstream>
+#include <string>
 #include <stuff/io/filesystem.h>
 
 using namespace stuff::io;
@@ -48,3 +50,34 @@ TEST_CASE("strings can be converted to paths", "[filesystem]")
         REQUIRE(expand_home("/some/path") == "/some/path");
     }
 }
+
+TEST_CASE("read only the lines that match", "[filesystem]")
+{
+    const fs::path filename {fs::temp_directory_path() / fs::unique_path()};
+
+    // enough lines to span a few blocks
+    std::size_t expected = 0;
+    {
+        std::ofstream file {filename.native()};
+        for (int i = 0; i < 200000; ++i) {
+            const char* symbol = (i % 3 == 0) ? "EUR/USD" : "GBP/CHF";
+            file << i << ',' << symbol << ",1.08231\n";
+            expected += (i % 3 == 0) ? 1 : 0;
+        }
+        file << "0,USD/JPY,107.5"; // without a new line
+    }
+
+    stuff::string::multi_matcher symbols {"EUR/USD", "USD/JPY"};
+    std::size_t                  count = 0;
+    std::string                  last;
+    read_as_lines(filename, compression_type::none, symbols,
+        [&](std::string_view line) {
+            REQUIRE(line.find('\n') == std::string_view::npos);
+            ++count;
+            last = line;
+        });
+    fs::remove(filename);
+
+    REQUIRE(count == expected + 1);
+    REQUIRE(last == "0,USD/JPY,107.5");
+}
@@ -0,0 +1,135 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <algorithm>
+#include <catch2/catch.hpp>
+#include <cctype>
+#include <random>
+#include <string>
+#include <stuff/string/ascii.h>
+
+using namespace stuff::string;
+
+TEST_CASE("trim whitespace", "[string]")
+{
+    REQUIRE(trim("") == "");
+    REQUIRE(trim(" \t\r\n\v\f") == "");
+    REQUIRE(trim("one") == "one");
+    REQUIRE(trim("  one two \r\n") == "one two");
+    REQUIRE(ltrim("  one  ") == "one  ");
+    REQUIRE(rtrim("  one  ") == "  one");
+
+    // longer than the 16 or 32 characters checked at once
+    std::string spaces(100, ' ');
+    auto        text = spaces + "one" + spaces;
+    REQUIRE(trim(text) == "one");
+    REQUIRE(ltrim(text).size() == 103);
+    REQUIRE(rtrim(text).size() == 103);
+    REQUIRE(trim(spaces).empty());
+
+    // the result is a view of the original string
+    REQUIRE(trim(text).data() == text.data() + 100);
+}
+
+TEST_CASE("convert the case of ASCII strings", "[string]")
+{
+    std::string text {"EUR/usd 1.08231 Zz@[`{"};
+    to_upper_ascii(text);
+    REQUIRE(text == "EUR/USD 1.08231 ZZ@[`{");
+    to_lower_ascii(text);
+    REQUIRE(text == "eur/usd 1.08231 zz@[`{");
+
+    // bytes outside of ASCII are unchanged
+    std::string utf8 {"\xc3\xa9t\xc3\xa9"};
+    to_upper_ascii(utf8);
+    REQUIRE(utf8 == "\xc3\xa9T\xc3\xa9");
+}
+
+TEST_CASE("check the class of every character", "[string]")
+{
+    REQUIRE(all_of_class("", char_class::digit));
+    REQUIRE(all_of_class("0123456789", char_class::digit));
+    REQUIRE_FALSE(all_of_class("0123456789a", char_class::digit));
+    REQUIRE(all_of_class("AZaz", char_class::alpha));
+    REQUIRE_FALSE(all_of_class("A@", char_class::alpha));
+    REQUIRE(all_of_class("EURUSD2020", char_class::alnum));
+    REQUIRE_FALSE(all_of_class("EUR/USD", char_class::alnum));
+    REQUIRE(all_of_class(" \t\r\n", char_class::space));
+    REQUIRE_FALSE(all_of_class(" x ", char_class::space));
+
+    std::string digits(100, '7');
+    REQUIRE(all_of_class(digits, char_class::digit));
+    digits[70] = '/';
+    REQUIRE_FALSE(all_of_class(digits, char_class::digit));
+}
+
+TEST_CASE("compare with <cctype>", "[string]")
+{
+    // random lengths cover every mix of vector blocks and scalar remainders
+    std::mt19937                       gen {42};
+    std::uniform_int_distribution<int> byte {0, 255};
+    std::uniform_int_distribution<int> length {0, 80};
+    std::uniform_int_distribution<int> padding {0, 40};
+
+    auto is = [](auto f) {
+        return [f](char c) { return f(static_cast<unsigned char>(c)) != 0; };
+    };
+
+    for (int i = 0; i < 1000; ++i) {
+        std::string text;
+        for (int j = length(gen); j > 0; --j) {
+            text += static_cast<char>(byte(gen));
+        }
+
+        auto upper = text;
+        auto lower = text;
+        to_upper_ascii(upper);
+        to_lower_ascii(lower);
+        for (size_t j = 0; j < text.size(); ++j) {
+            auto c = static_cast<unsigned char>(text[j]);
+            REQUIRE(upper[j] == (c < 128 ? std::toupper(c) : text[j]));
+            REQUIRE(lower[j] == (c < 128 ? std::tolower(c) : text[j]));
+        }
+
+        auto ascii = [&text](auto f) {
+            return std::all_of(text.begin(), text.end(), [f](char c) {
+                return static_cast<unsigned char>(c) < 128 && f(c);
+            });
+        };
+        REQUIRE(all_of_class(text, char_class::digit)
+                == ascii(is([](int c) { return std::isdigit(c); })));
+        REQUIRE(all_of_class(text, char_class::alpha)
+                == ascii(is([](int c) { return std::isalpha(c); })));
+        REQUIRE(all_of_class(text, char_class::alnum)
+                == ascii(is([](int c) { return std::isalnum(c); })));
+
+        // classes are rarely all true for random bytes, so check some that are
+        std::string digits(static_cast<size_t>(length(gen)), '5');
+        REQUIRE(all_of_class(digits, char_class::digit));
+        REQUIRE(all_of_class(digits, char_class::alnum));
+
+        std::string padded = std::string(padding(gen), ' ') + text
+                             + std::string(padding(gen), '\t');
+        auto first = std::find_if_not(padded.begin(), padded.end(),
+            is([](int c) { return std::isspace(c); }));
+        auto last = std::find_if_not(padded.rbegin(), padded.rend(),
+            is([](int c) { return std::isspace(c); }))
+                        .base();
+        auto expected = first < last ? std::string(first, last) : "";
+        REQUIRE(trim(padded) == expected);
+    }
+}
@@ -16,8 +16,17 @@
 //
 
 #include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fmt/format.h>
+#include <limits>
+#include <random>
+#include <iterator>
 #include <string>
 #include <stuff/string/convert.h>
+#include <vector>
 
 using namespace stuff::string;
 
@@ -44,5 +53,286 @@ TEST_CASE("convert a string to a number", "[string]")
         REQUIRE(to_number<int>("1") == 1);
         REQUIRE(to_number<int>("123456", 0) == 123456);
         REQUIRE(to_number<int>("123456") == 123456);
+        REQUIRE(to_number<int>("-123456") == -123456);
+        REQUIRE(to_number<int>("+123456") == 123456);
+        REQUIRE(to_number<long>("1234567890123456789") == 1234567890123456789);
+        REQUIRE(to_number<long>("-0001234567890123456789")
+                == -1234567890123456789);
+        REQUIRE(to_number<unsigned>("00000000000000000000042") == 42);
+    }
+
+    SECTION("the limits of an integer")
+    {
+        REQUIRE(to_number<int>("2147483647") == 2147483647);
+        REQUIRE(to_number<int>("-2147483648") == -2147483647 - 1);
+        REQUIRE_THROWS(to_number<int>("2147483648"));
+        REQUIRE_THROWS(to_number<int>("-2147483649"));
+
+        REQUIRE(to_number<long>("9223372036854775807")
+                == std::numeric_limits<long>::max());
+        REQUIRE(to_number<long>("-9223372036854775808")
+                == std::numeric_limits<long>::min());
+        REQUIRE_THROWS(to_number<long>("9223372036854775808"));
+
+        REQUIRE(to_number<unsigned long>("18446744073709551615")
+                == std::numeric_limits<unsigned long>::max());
+        REQUIRE_THROWS(to_number<unsigned long>("18446744073709551616"));
+        REQUIRE_THROWS(to_number<unsigned long>("100000000000000000000"));
+        REQUIRE_THROWS(to_number<unsigned>("-1"));
+        REQUIRE(to_number<unsigned>("-0") == 0);
+
+        REQUIRE(to_number<std::int8_t>("-128") == -128);
+        REQUIRE_THROWS(to_number<std::int8_t>("128"));
+    }
+
+    SECTION("a bad integer")
+    {
+        REQUIRE_THROWS_AS(to_number<int>("-"), string_conversion_error);
+        REQUIRE_THROWS_AS(to_number<int>("+", 0), string_conversion_error);
+        REQUIRE_THROWS(to_number<int>(" 1"));
+        REQUIRE_THROWS(to_number<int>("1 "));
+        REQUIRE_THROWS(to_number<long>("12345678z"));
+        REQUIRE_THROWS(to_number<long>("1234567890123456789z"));
+        REQUIRE_THROWS(to_number<long>("1.5"));
+    }
+}
+
+TEST_CASE("convert a string to a floating-point number", "[string]")
+{
+    // the result must match strtod/strtof bit for bit
+    auto same_as_strtod = [](const std::string& str) {
+        double expected = std::strtod(str.c_str(), nullptr);
+        double actual   = to_number<double>(str);
+        return std::memcmp(&expected, &actual, sizeof(double)) == 0;
+    };
+    auto same_as_strtof = [](const std::string& str) {
+        float expected = std::strtof(str.c_str(), nullptr);
+        float actual   = to_number<float>(str);
+        return std::memcmp(&expected, &actual, sizeof(float)) == 0;
+    };
+
+    SECTION("an empty string")
+    {
+        REQUIRE(to_number<double>("", 0.5) == 0.5);
+        REQUIRE_THROWS(to_number<double>(""));
+    }
+
+    SECTION("a bad string")
+    {
+        REQUIRE_THROWS_AS(to_number<double>("1.2z"), string_conversion_error);
+        REQUIRE_THROWS(to_number<double>("."));
+        REQUIRE_THROWS(to_number<double>("-"));
+        REQUIRE_THROWS(to_number<double>("1e"));
+        REQUIRE_THROWS(to_number<double>("1e+"));
+        REQUIRE_THROWS(to_number<double>(" 1.5"));
+        REQUIRE_THROWS(to_number<double>("1.5 "));
+        REQUIRE_THROWS(to_number<double>("+-1.5"));
+        REQUIRE_THROWS(to_number<float>("abc"));
+    }
+
+    SECTION("a good number")
+    {
+        REQUIRE(to_number<double>("1.2345678901") == 1.2345678901);
+        REQUIRE(to_number<double>("-1.5") == -1.5);
+        REQUIRE(to_number<double>("+1.5") == 1.5);
+        REQUIRE(to_number<double>("1.") == 1.0);
+        REQUIRE(to_number<double>(".5") == 0.5);
+        REQUIRE(to_number<double>("15e-1") == 1.5);
+        REQUIRE(to_number<double>("1E3") == 1000.0);
+        REQUIRE(to_number<float>("1.08231") == 1.08231f);
+        REQUIRE(std::signbit(to_number<double>("-0")));
+        REQUIRE(std::isinf(to_number<double>("inf")));
+        REQUIRE(std::isnan(to_number<double>("nan")));
+    }
+
+    SECTION("hard cases")
+    {
+        for (const auto* str : {"2.2250738585072011e-308",
+                 "2.2250738585072012e-308", "4.9406564584124654e-324",
+                 "2.4703282292062327e-324", "2.4703282292062328e-324",
+                 "1.7976931348623157e308", "1.7976931348623158e308",
+                 "1e400", "-1e400", "1e-400", "9007199254740993",
+                 "9007199254740992.000000000000000000001",
+                 "0.000000000000000000000000000000000000001e39",
+                 "7.038531e-26", "1.00000005960464477550"}) {
+            INFO(str);
+            REQUIRE(same_as_strtod(str));
+            REQUIRE(same_as_strtof(str));
+        }
+    }
+
+    SECTION("random numbers")
+    {
+        std::mt19937_64                    gen {42};
+        std::uniform_int_distribution<int> digits {1, 22};
+        std::uniform_int_distribution<int> exponent {-340, 310};
+        std::uniform_int_distribution<int> digit {0, 9};
+        for (int i = 0; i < 20000; ++i) {
+            // arbitrary digits and exponents
+            std::string str;
+            for (int n = digits(gen); n > 0; --n) {
+                str += static_cast<char>('0' + digit(gen));
+            }
+            str.insert(gen() % str.size(), ".");
+            str += fmt::format("e{}", exponent(gen));
+            INFO(str);
+            REQUIRE(same_as_strtod(str));
+            REQUIRE(same_as_strtof(str));
+
+            // the shortest round-trip strings of random doubles
+            double d;
+            auto   bits = gen();
+            std::memcpy(&d, &bits, sizeof(d));
+            if (std::isfinite(d)) {
+                str = fmt::format("{}", d);
+                INFO(str);
+                REQUIRE(same_as_strtod(str));
+                REQUIRE(to_number<double>(str) == d);
+            }
+        }
+    }
+}
+
+TEST_CASE("convert many strings to numbers", "[string]")
+{
+    SECTION("from an array of strings")
+    {
+        std::vector<std::string_view> views {"1", "", "-3", "4"};
+        std::vector<long>             numbers(views.size());
+        auto                          end
+            = to_numbers(views.begin(), views.end(), numbers.begin(), 0L);
+        REQUIRE(end == numbers.end());
+        REQUIRE(numbers == std::vector<long> {1, 0, -3, 4});
+
+        std::vector<std::string> strings {"1.5", "", "-2.25"};
+        std::vector<double>      reals;
+        to_numbers(strings.begin(), strings.end(), std::back_inserter(reals),
+            -1.0);
+        REQUIRE(reals == std::vector<double> {1.5, -1.0, -2.25});
+
+        views = {"1", "2", "x"};
+        REQUIRE_THROWS_AS(
+            to_numbers(views.begin(), views.end(), numbers.begin(), 0L),
+            string_conversion_error);
+    }
+
+    SECTION("from a delimited buffer")
+    {
+        REQUIRE(to_numbers("1,2,,4", ',', 0) == std::vector<int> {1, 2, 0, 4});
+        REQUIRE(to_numbers("1.5\n2.5\n", '\n', 0.0)
+                == std::vector<double> {1.5, 2.5, 0.0});
+        REQUIRE(to_numbers("", ',', 7) == std::vector<int> {7});
+        REQUIRE_THROWS_AS(to_numbers("1,2,q", ',', 0), string_conversion_error);
+
+        // appends to the result
+        std::vector<int> numbers {9};
+        to_numbers("1,2", ',', 0, numbers);
+        REQUIRE(numbers == std::vector<int> {9, 1, 2});
+    }
+}
+
+TEST_CASE("convert a string to a fixed-point number", "[string]")
+{
+    using std::int64_t;
+
+    SECTION("an empty string")
+    {
+        REQUIRE(to_fixed<int64_t, 8>("", -1) == -1);
+        REQUIRE_THROWS(to_fixed<int64_t, 8>(""));
+    }
+
+    SECTION("a bad string")
+    {
+        REQUIRE_THROWS_AS(
+            (to_fixed<int64_t, 8>("1.2z")), string_conversion_error);
+        REQUIRE_THROWS(to_fixed<int64_t, 8>("."));
+        REQUIRE_THROWS(to_fixed<int64_t, 8>("-"));
+        REQUIRE_THROWS(to_fixed<int64_t, 8>("1.2.3"));
+        REQUIRE_THROWS(to_fixed<int64_t, 8>("1e5"));
+        REQUIRE_THROWS(to_fixed<int64_t, 2>("1.001z"));
+    }
+
+    SECTION("a good number")
+    {
+        REQUIRE(to_fixed<int64_t, 8>("1.08231") == 108231000);
+        REQUIRE(to_fixed<int64_t, 8>("-1.08231") == -108231000);
+        REQUIRE(to_fixed<int64_t, 8>("+1.08231") == 108231000);
+        REQUIRE(to_fixed<int64_t, 8>("42") == 4200000000);
+        REQUIRE(to_fixed<int64_t, 8>("42.") == 4200000000);
+        REQUIRE(to_fixed<int64_t, 8>(".5") == 50000000);
+        REQUIRE(to_fixed<int64_t, 8>("0.00000001") == 1);
+        REQUIRE(to_fixed<int64_t, 8>("12345678901.12345678")
+                == 1234567890112345678);
+        REQUIRE(to_fixed<int64_t, 0>("123") == 123);
+        REQUIRE(to_fixed<int, 2>("-21474836.48") == -2147483647 - 1);
+    }
+
+    SECTION("overflow")
+    {
+        REQUIRE_THROWS(to_fixed<int64_t, 8>("92233720368.54775808"));
+        REQUIRE(to_fixed<int64_t, 8>("92233720368.54775807")
+                == std::numeric_limits<int64_t>::max());
+        REQUIRE_THROWS(to_fixed<int, 2>("21474836.48"));
+        REQUIRE_THROWS(to_fixed<unsigned, 2>("-1.00"));
+    }
+
+    SECTION("excess digits")
+    {
+        REQUIRE(to_fixed<int64_t, 2>("1.2300000") == 123);
+        REQUIRE_THROWS(to_fixed<int64_t, 2>("1.2345"));
+
+        REQUIRE(to_fixed<int64_t, 2, excess_digits::round>("1.2345") == 123);
+        REQUIRE(to_fixed<int64_t, 2, excess_digits::round>("1.235") == 124);
+        REQUIRE(to_fixed<int64_t, 2, excess_digits::round>("-1.235") == -124);
+        REQUIRE(to_fixed<int64_t, 2, excess_digits::round>("9.999") == 1000);
+        REQUIRE(to_fixed<int64_t, 0, excess_digits::round>("2.5") == 3);
+
+        REQUIRE(to_fixed<int64_t, 2, excess_digits::truncate>("1.239") == 123);
+        REQUIRE(
+            to_fixed<int64_t, 2, excess_digits::truncate>("-1.239") == -123);
+    }
+}
+
+TEST_CASE("convert a string to a number without throwing", "[string]")
+{
+    SECTION("to_number")
+    {
+        auto result = try_to_number<int>("42");
+        REQUIRE(result);
+        REQUIRE(result.value == 42);
+
+        REQUIRE(try_to_number<int>("", 7).value == 7);
+        REQUIRE(try_to_number<int>("").ec == std::errc::invalid_argument);
+        REQUIRE(try_to_number<int>("12z34").ec == std::errc::invalid_argument);
+        REQUIRE(try_to_number<int>("1.5").ec == std::errc::invalid_argument);
+        REQUIRE(try_to_number<int>("2147483648").ec
+                == std::errc::result_out_of_range);
+        REQUIRE(try_to_number<unsigned>("-1").ec
+                == std::errc::result_out_of_range);
+        REQUIRE_FALSE(try_to_number<int>("-"));
+
+        REQUIRE(try_to_number<double>("1.5").value == 1.5);
+        REQUIRE(
+            try_to_number<double>("1.5x").ec == std::errc::invalid_argument);
+    }
+
+    SECTION("to_fixed")
+    {
+        REQUIRE((try_to_fixed<long, 2>("1.25").value == 125));
+        REQUIRE((try_to_fixed<long, 2>("", -1).value == -1));
+        REQUIRE((try_to_fixed<long, 2>("1.2z").ec
+                 == std::errc::invalid_argument));
+        REQUIRE((try_to_fixed<long, 2>("1.234").ec
+                 == std::errc::result_out_of_range));
+        REQUIRE((try_to_fixed<int, 2>("99999999.99").ec
+                 == std::errc::result_out_of_range));
+    }
+
+    SECTION("the throwing versions report the error")
+    {
+        REQUIRE_THROWS_WITH(to_number<int>("2147483648"),
+            Catch::Contains("out of range"));
+        REQUIRE_THROWS_WITH(to_number<int>("x"),
+            Catch::Contains("can not convert"));
     }
 }
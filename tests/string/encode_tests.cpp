@@ -0,0 +1,119 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <stuff/string/encode.h>
+
+using namespace stuff::container;
+using namespace stuff::string;
+
+namespace {
+
+    std::string as_string(const byte_array& bytes)
+    {
+        return std::string {bytes.begin(), bytes.end()};
+    }
+
+} // namespace
+
+TEST_CASE("convert bytes to and from hexadecimal", "[string]")
+{
+    REQUIRE(to_hex("").empty());
+    REQUIRE(to_hex(std::string_view {"\x00\x7f\x80\xff", 4}) == "007f80ff");
+    REQUIRE(to_hex(byte_array {'\x12', '\xab'}) == "12ab");
+    REQUIRE(as_string(from_hex("007f80FF"))
+            == std::string {"\x00\x7f\x80\xff", 4});
+    REQUIRE(from_hex("").empty());
+
+    REQUIRE_THROWS_AS(from_hex("abc"), encoding_error);
+    REQUIRE_THROWS_AS(from_hex("0g"), encoding_error);
+
+    // an invalid character in a block converted at once
+    std::string text(200, 'a');
+    REQUIRE(from_hex(text).size() == 100);
+    text[101] = 'x';
+    REQUIRE_THROWS_AS(from_hex(text), encoding_error);
+}
+
+TEST_CASE("convert bytes to and from base64", "[string]")
+{
+    // RFC 4648 test vectors
+    REQUIRE(to_base64("") == "");
+    REQUIRE(to_base64("f") == "Zg==");
+    REQUIRE(to_base64("fo") == "Zm8=");
+    REQUIRE(to_base64("foo") == "Zm9v");
+    REQUIRE(to_base64("foob") == "Zm9vYg==");
+    REQUIRE(to_base64("fooba") == "Zm9vYmE=");
+    REQUIRE(to_base64("foobar") == "Zm9vYmFy");
+
+    REQUIRE(as_string(from_base64("Zm9vYmE=")) == "fooba");
+    REQUIRE(as_string(from_base64("Zm9vYmE")) == "fooba");
+    REQUIRE(as_string(from_base64("Zm9vYg==")) == "foob");
+    REQUIRE(as_string(from_base64("Zm9vYg")) == "foob");
+    REQUIRE(from_base64("").empty());
+
+    REQUIRE_THROWS_AS(from_base64("Zm9vY"), encoding_error);
+    REQUIRE_THROWS_AS(from_base64("Zm9vYg="), encoding_error);
+    REQUIRE_THROWS_AS(from_base64("Zm9v Yg=="), encoding_error);
+
+    // the unused bits of the last quantum must be 0 (e.g., "QR==" is not
+    // "QQ==" of "A"), so there is only one base64 of any bytes
+    REQUIRE(as_string(from_base64("QQ==")) == "A");
+    REQUIRE_THROWS_AS(from_base64("QR=="), encoding_error);
+    REQUIRE_THROWS_AS(from_base64("QR"), encoding_error);
+    REQUIRE(as_string(from_base64("QUI=")) == "AB");
+    REQUIRE_THROWS_AS(from_base64("QUJ="), encoding_error);
+    auto long_text = to_base64(std::string(100, 'A'));
+    REQUIRE(long_text.substr(long_text.size() - 4) == "QQ==");
+    long_text[long_text.size() - 3] = 'R';
+    REQUIRE_THROWS_AS(from_base64(long_text), encoding_error);
+
+    std::string text(200, 'A');
+    REQUIRE(from_base64(text).size() == 150);
+    text[100] = '*';
+    REQUIRE_THROWS_AS(from_base64(text), encoding_error);
+}
+
+TEST_CASE("round trip random bytes", "[string]")
+{
+    // random sizes cover every mix of vector blocks and scalar remainders
+    std::mt19937                       gen {11};
+    std::uniform_int_distribution<int> byte {0, 255};
+    std::uniform_int_distribution<int> length {0, 300};
+
+    for (int i = 0; i < 500; ++i) {
+        byte_array bytes;
+        for (int j = length(gen); j > 0; --j) {
+            bytes.push_back(static_cast<char>(byte(gen)));
+        }
+
+        auto hex = to_hex(bytes);
+        REQUIRE(hex.size() == 2 * bytes.size());
+        REQUIRE(from_hex(hex) == bytes);
+        for (std::size_t j = 0; j < bytes.size(); ++j) {
+            auto value = static_cast<unsigned char>(bytes[j]);
+            REQUIRE(hex[2 * j] == "0123456789abcdef"[value >> 4]);
+            REQUIRE(hex[2 * j + 1] == "0123456789abcdef"[value & 0x0F]);
+        }
+
+        auto base64 = to_base64(bytes);
+        REQUIRE(base64.size() == 4 * ((bytes.size() + 2) / 3));
+        REQUIRE(from_base64(base64) == bytes);
+    }
+}
@@ -0,0 +1,137 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <random>
+#include <string>
+#include <stuff/string/convert.h>
+#include <stuff/string/format.h>
+
+using namespace stuff::string;
+
+template <typename T>
+std::string format(T value)
+{
+    char buffer[max_number_size<T>];
+    return std::string(buffer, format_number(buffer, value));
+}
+
+TEST_CASE("convert a number to a string", "[string]")
+{
+    SECTION("integers")
+    {
+        REQUIRE(format(0) == "0");
+        REQUIRE(format(7) == "7");
+        REQUIRE(format(42) == "42");
+        REQUIRE(format(-42) == "-42");
+        REQUIRE(format(100) == "100");
+        REQUIRE(format(123456789) == "123456789");
+        REQUIRE(format(std::numeric_limits<int>::min()) == "-2147483648");
+        REQUIRE(format(std::numeric_limits<long>::min())
+                == "-9223372036854775808");
+        REQUIRE(format(std::numeric_limits<unsigned long>::max())
+                == "18446744073709551615");
+        REQUIRE(format(std::int8_t {-128}) == "-128");
+
+        std::mt19937_64 gen {42};
+        for (int i = 0; i < 1000; ++i) {
+            auto n = static_cast<long>(gen()) >> (gen() % 64);
+            REQUIRE(format(n) == std::to_string(n));
+        }
+    }
+
+    SECTION("floating-point numbers")
+    {
+        REQUIRE(format(1.5) == "1.5");
+        REQUIRE(format(-0.1) == "-0.1");
+        REQUIRE(format(1.08231f) == "1.08231");
+        REQUIRE(format(1e300) == "1e+300");
+        REQUIRE(format(-2.2250738585072014e-308) == "-2.2250738585072014e-308");
+
+        // the shortest string converts back to the same value
+        std::mt19937_64 gen {42};
+        for (int i = 0; i < 1000; ++i) {
+            auto   exponent = static_cast<int>(gen() % 200) - 100;
+            double d = std::ldexp(static_cast<double>(gen()), exponent);
+            REQUIRE(to_number<double>(format(d)) == d);
+        }
+    }
+
+    SECTION("fixed precision")
+    {
+        char buffer[32];
+        auto fixed = [&buffer](double value, int precision) {
+            char* end = format_fixed(
+                buffer, buffer + sizeof(buffer), value, precision);
+            return std::string(buffer, end);
+        };
+        REQUIRE(fixed(1.08231, 5) == "1.08231");
+        REQUIRE(fixed(1.5, 3) == "1.500");
+        REQUIRE(fixed(-0.125, 2) == "-0.12");
+        REQUIRE(fixed(2.675, 2) == "2.67"); // 2.675 is 2.67499999...
+        REQUIRE(fixed(1234.5, 0) == "1234");
+
+        REQUIRE(format_fixed(buffer, buffer + 3, 1234.5, 2) == nullptr);
+    }
+}
+
+TEST_CASE("build a string in an output_buffer", "[string]")
+{
+    output_buffer out {4};
+    REQUIRE(out.empty());
+
+    out.append("EUR/USD").append(',').append_number(42).append(',');
+    out.append_number(-1.5).append(',').append_fixed(1.08231, 2);
+    REQUIRE(out.view() == "EUR/USD,42,-1.5,1.08");
+    REQUIRE(out.str() == "EUR/USD,42,-1.5,1.08");
+
+    // clear() keeps the memory
+    auto capacity = out.capacity();
+    out.clear();
+    REQUIRE(out.empty());
+    REQUIRE(out.capacity() == capacity);
+
+    // a number that needs more room than the default
+    out.append_fixed(1e100, 2);
+    REQUIRE(out.size() == 104);
+    REQUIRE(out.view().substr(0, 2) == "10");
+    REQUIRE(out.view().substr(101) == ".00");
+}
+
+TEST_CASE("move an output_buffer", "[string]")
+{
+    output_buffer out {4};
+    out.append("EUR/USD");
+
+    output_buffer moved {std::move(out)};
+    REQUIRE(moved.view() == "EUR/USD");
+
+    // the moved-from buffer is empty and grows again
+    REQUIRE(out.empty());
+    REQUIRE(out.capacity() == 0);
+    out.append("GBP/USD").append(',').append_fixed(1.25, 2);
+    REQUIRE(out.view() == "GBP/USD,1.25");
+
+    moved = std::move(out);
+    REQUIRE(moved.view() == "GBP/USD,1.25");
+    REQUIRE(out.empty());
+    out.append_number(42);
+    REQUIRE(out.view() == "42");
+}
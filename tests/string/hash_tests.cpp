@@ -0,0 +1,85 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <set>
+#include <string>
+#include <stuff/string/hash.h>
+
+using namespace stuff::container;
+using namespace stuff::string;
+
+namespace {
+
+    std::string make_data(std::size_t n)
+    {
+        std::string data;
+        for (std::size_t i = 0; i < n; ++i) {
+            data.push_back(static_cast<char>(i * 31 + 7));
+        }
+        return data;
+    }
+
+} // namespace
+
+TEST_CASE("hash strings", "[string]")
+{
+    const auto data = make_data(4096);
+    auto       hash = [&](std::size_t n, std::uint64_t seed = 0) {
+        return hash64(std::string_view {data.data(), n}, seed);
+    };
+
+    // the same values on every CPU (i.e., with or without AVX2)
+    REQUIRE(hash(0) == 0xa7d945e0b48fd464);
+    REQUIRE(hash(3) == 0x627575c0b7be69b2);
+    REQUIRE(hash(8) == 0x3cf976095db4e820);
+    REQUIRE(hash(16) == 0x634b8d3390bbeb08);
+    REQUIRE(hash(100) == 0x8219ce3ab2eee50b);
+    REQUIRE(hash(128) == 0x12e0fcbebc2d70c2);
+    REQUIRE(hash(129) == 0x06aae954c017481e);
+    REQUIRE(hash(1024) == 0xc3be61411fac107b);
+    REQUIRE(hash(1025) == 0x1b650bc91b795e9b);
+    REQUIRE(hash(4096) == 0x36948149a68e6f9b);
+
+    REQUIRE(hash(100, 1) != hash(100));
+    REQUIRE(hash64(byte_array {'a', 'b', 'c'}) == hash64("abc"));
+
+    // every length and a change of one byte give different values
+    std::set<std::uint64_t> values;
+    for (std::size_t n = 0; n <= data.size(); ++n) {
+        values.insert(hash(n));
+    }
+    REQUIRE(values.size() == data.size() + 1);
+
+    auto changed = data;
+    changed[2000] ^= 1;
+    REQUIRE(hash64(changed) != hash64(data));
+}
+
+TEST_CASE("checksum strings", "[string]")
+{
+    // the check value of CRC-32C
+    REQUIRE(crc32c("123456789") == 0xe3069283);
+    REQUIRE(crc32c("") == 0);
+    REQUIRE(crc32c("56789", crc32c("1234")) == crc32c("123456789"));
+    REQUIRE(crc32c(byte_array {'1', '2', '3'}) == crc32c("123"));
+
+    const auto data = make_data(1000);
+    const auto head = std::string_view {data}.substr(0, 333);
+    const auto tail = std::string_view {data}.substr(333);
+    REQUIRE(crc32c(tail, crc32c(head)) == crc32c(data));
+}
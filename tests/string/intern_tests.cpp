@@ -0,0 +1,103 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <fmt/format.h>
+#include <string>
+#include <stuff/string/intern.h>
+#include <thread>
+#include <vector>
+
+using namespace stuff::string;
+
+TEST_CASE("intern strings in a symbol_table", "[string]")
+{
+    symbol_table symbols;
+    REQUIRE(symbols.size() == 0);
+    REQUIRE_FALSE(symbols.find("EUR/USD"));
+
+    // IDs are assigned in order and are stable
+    auto eur = symbols.intern("EUR/USD");
+    auto jpy = symbols.intern("USD/JPY");
+    REQUIRE(eur == 0);
+    REQUIRE(jpy == 1);
+    REQUIRE(symbols.intern("EUR/USD") == eur);
+    REQUIRE(symbols.size() == 2);
+
+    // the table owns a copy of each string
+    std::string temp {"GBP/USD"};
+    auto        gbp = symbols.intern(temp);
+    temp            = "overwritten";
+    REQUIRE(symbols.view(gbp) == "GBP/USD");
+    REQUIRE(symbols.find("GBP/USD") == gbp);
+
+    // views remain valid as the table grows
+    auto view = symbols.view(eur);
+    for (int i = 0; i < 100000; ++i) {
+        symbols.intern(fmt::format("symbol {}", i));
+    }
+    REQUIRE(view == "EUR/USD");
+    REQUIRE(view.data() == symbols.view(eur).data());
+    REQUIRE(symbols.view(symbols.intern("symbol 99999")) == "symbol 99999");
+
+    // empty and very long strings
+    REQUIRE(symbols.view(symbols.intern("")).empty());
+    std::string big(1000000, 'x');
+    REQUIRE(symbols.view(symbols.intern(big)) == big);
+}
+
+TEST_CASE("intern strings in a concurrent_symbol_table", "[string]")
+{
+    concurrent_symbol_table symbols;
+
+    auto eur = symbols.intern("EUR/USD");
+    REQUIRE(symbols.intern("EUR/USD") == eur);
+    REQUIRE(symbols.find("EUR/USD") == eur);
+    REQUIRE_FALSE(symbols.find("USD/JPY"));
+    REQUIRE(symbols.view(eur) == "EUR/USD");
+
+    // many threads interning the same strings get the same IDs
+    constexpr int                       count = 1000;
+    std::vector<std::vector<symbol_id>> ids(4);
+    std::vector<std::thread>            threads;
+    for (auto& thread_ids : ids) {
+        threads.emplace_back([&symbols, &thread_ids]() {
+            for (int i = 0; i < count; ++i) {
+                thread_ids.push_back(
+                    symbols.intern(fmt::format("symbol {}", i)));
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+
+    REQUIRE(symbols.size() == count + 1);
+    for (int i = 0; i < count; ++i) {
+        REQUIRE(ids[0][i] == ids[1][i]);
+        REQUIRE(ids[0][i] == ids[3][i]);
+        REQUIRE(symbols.view(ids[2][i]) == fmt::format("symbol {}", i));
+    }
+}
+
+TEST_CASE("too many shards for a concurrent_symbol_table", "[string]")
+{
+    REQUIRE_NOTHROW(concurrent_symbol_table {15});
+    REQUIRE_THROWS_AS(concurrent_symbol_table {16}, symbol_table_error);
+    REQUIRE_THROWS_AS(concurrent_symbol_table {64}, symbol_table_error);
+    REQUIRE_THROWS_AS(concurrent_symbol_table {1000}, symbol_table_error);
+}
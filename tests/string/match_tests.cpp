@@ -0,0 +1,109 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <random>
+#include <string>
+#include <stuff/string/match.h>
+#include <vector>
+
+using namespace stuff::string;
+
+TEST_CASE("find any of many patterns", "[string]")
+{
+    multi_matcher symbols {"EUR/USD", "USD/JPY", "USD"};
+    REQUIRE(symbols.size() == 3);
+
+    REQUIRE(symbols.contains("2015-03-14T15:09:26Z,EUR/USD,1.08231"));
+    REQUIRE(symbols.contains("USD"));
+    REQUIRE_FALSE(symbols.contains("2015-03-14T15:09:26Z,GBP/CHF,1.08231"));
+    REQUIRE_FALSE(symbols.contains(""));
+    REQUIRE_FALSE(symbols.contains("US"));
+
+    // the pattern that ends first wins, then the longest
+    auto match = symbols.find("x,EUR/USD/JPY");
+    REQUIRE(match);
+    REQUIRE(match->pattern == 0);
+    REQUIRE(match->position == 2);
+
+    match = symbols.find("x,USD/JPY");
+    REQUIRE(match);
+    REQUIRE(match->pattern == 2);
+    REQUIRE(match->position == 2);
+
+    // past the characters that are skipped 32 at a time
+    std::string line(200, '1');
+    REQUIRE_FALSE(symbols.contains(line));
+    line += "USD/JPY";
+    match = symbols.find(line);
+    REQUIRE(match);
+    REQUIRE(match->position == 200);
+
+    REQUIRE_THROWS_AS(multi_matcher({"EUR", ""}), multi_matcher_error);
+}
+
+TEST_CASE("compare a multi_matcher with std::string::find", "[string]")
+{
+    // a small alphabet makes overlapping patterns and matches common
+    std::mt19937                       gen {7};
+    std::uniform_int_distribution<int> letter {0, 3};
+    std::uniform_int_distribution<int> pattern_length {1, 5};
+    std::uniform_int_distribution<int> text_length {0, 150};
+
+    auto random_string = [&](int length) {
+        std::string s;
+        for (int i = 0; i < length; ++i) {
+            s += "ab,\xe9"[letter(gen)];
+        }
+        return s;
+    };
+
+    for (int i = 0; i < 200; ++i) {
+        std::vector<std::string> patterns;
+        for (int j = 0; j < 5; ++j) {
+            patterns.push_back(random_string(pattern_length(gen)));
+        }
+        multi_matcher matcher {patterns.begin(), patterns.end()};
+
+        for (int j = 0; j < 20; ++j) {
+            auto text = random_string(text_length(gen));
+
+            // the first end, then the longest
+            std::size_t best_end = std::string::npos;
+            std::size_t best_len = 0;
+            for (const auto& pattern : patterns) {
+                auto pos = text.find(pattern);
+                if (pos == std::string::npos) {
+                    continue;
+                }
+                auto end = pos + pattern.size();
+                if (best_end == std::string::npos || end < best_end
+                    || (end == best_end && pattern.size() > best_len)) {
+                    best_end = end;
+                    best_len = pattern.size();
+                }
+            }
+
+            auto match = matcher.find(text);
+            REQUIRE(match.has_value() == (best_end != std::string::npos));
+            if (match) {
+                REQUIRE(match->position + best_len == best_end);
+                REQUIRE(patterns[match->pattern].size() == best_len);
+            }
+        }
+    }
+}
@@ -0,0 +1,97 @@
+//
+// Copyright (C) 2020  Tony Walker
+//
+// This program is free software: you can redistribute it and/or modify
+// it under the terms of the GNU Lesser General Public License as published by
+// the Free Software Foundation, either version 3 of the License, or
+// (at your option) any later version.
+//
+// This program is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU Lesser General Public License for more details.
+//
+// You should have received a copy of the GNU Lesser General Public License
+// along with this program.  If not, see <https://www.gnu.org/licenses/>.
+//
+
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <string_view>
+#include <stuff/string/record.h>
+#include <tuple>
+
+using namespace stuff::string;
+
+struct quote {
+    std::string_view symbol;
+    double           bid {0};
+    double           ask {0};
+    long             size {0};
+};
+
+template <>
+struct stuff::string::record_fields<quote> {
+    static constexpr auto members =
+        std::make_tuple(&quote::symbol, &quote::bid, &quote::ask, &quote::size);
+};
+
+TEST_CASE("parse a record into a tuple", "[string]")
+{
+    using record = std::tuple<std::int64_t, double, std::string_view, int>;
+
+    auto result = parse_record<record>("42,1.08231,EUR/USD,-7", ',');
+    REQUIRE(result);
+    auto& [id, price, symbol, count] = result.value;
+    REQUIRE(id == 42);
+    REQUIRE(price == 1.08231);
+    REQUIRE(symbol == "EUR/USD");
+    REQUIRE(count == -7);
+
+    SECTION("with a bad field")
+    {
+        auto bad = parse_record<record>("42,1.08x,EUR/USD,-7", ',');
+        REQUIRE_FALSE(bad);
+        REQUIRE(bad.ec == std::errc::invalid_argument);
+        REQUIRE(bad.field == 1);
+
+        bad = parse_record<record>("42,1.0,EUR/USD,99999999999", ',');
+        REQUIRE(bad.ec == std::errc::result_out_of_range);
+        REQUIRE(bad.field == 3);
+    }
+
+    SECTION("with too few or too many fields")
+    {
+        auto bad = parse_record<record>("42,1.0", ',');
+        REQUIRE(bad.ec == std::errc::invalid_argument);
+        REQUIRE(bad.field == 2);
+
+        bad = parse_record<record>("42,1.0,EUR/USD,7,", ',');
+        REQUIRE(bad.ec == std::errc::invalid_argument);
+        REQUIRE(bad.field == 4);
+
+        REQUIRE_FALSE(parse_record<record>("", ','));
+    }
+
+    SECTION("with a multi-character separator")
+    {
+        auto other = parse_record<record>(
+            "42||1.5||EUR/USD||7", string_separator {"||"});
+        REQUIRE(other);
+        REQUIRE(std::get<1>(other.value) == 1.5);
+    }
+}
+
+TEST_CASE("parse a record into a struct", "[string]")
+{
+    auto result = parse_record<quote>("EUR/USD 1.08231 1.08234 1000000");
+    REQUIRE(result);
+    REQUIRE(result.value.symbol == "EUR/USD");
+    REQUIRE(result.value.bid == 1.08231);
+    REQUIRE(result.value.ask == 1.08234);
+    REQUIRE(result.value.size == 1000000);
+
+    auto bad = parse_record<quote>("EUR/USD 1.08231  1000000");
+    REQUIRE(bad.ec == std::errc::invalid_argument);
+    REQUIRE(bad.field == 2);
+}
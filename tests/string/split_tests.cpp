@@ -15,7 +15,9 @@
 // along with this program.  If not, see <https://www.gnu.org/licenses/>.
 //
 
+#include <algorithm>
 #include <catch2/catch.hpp>
+#include <iterator>
 #include <string>
 #include <stuff/string/split.h>
 
@@ -247,3 +249,236 @@ TEST_CASE("split a string into a string_view_array", "[string]")
         REQUIRE(list[2] == "");
     }
 }
+
+TEST_CASE("split a string with split_view", "[string]")
+{
+    string_view_array list;
+    std::string       text;
+
+    SECTION("tokenizing an empty string")
+    {
+        text = "";
+        for (auto token : split_view(text, ' ')) {
+            list.push_back(token);
+        }
+        REQUIRE(list.size() == 1);
+        REQUIRE(list[0] == "");
+    }
+
+    SECTION("tokenizing two tokens")
+    {
+        text = "one two";
+        for (auto token : split_view(text, ' ')) {
+            list.push_back(token);
+        }
+        REQUIRE(list.size() == 2);
+        REQUIRE(list[0] == "one");
+        REQUIRE(list[1] == "two");
+    }
+
+    SECTION("tokenizing three empty tokens")
+    {
+        text = ",,";
+        for (auto token : split_view(text, ',')) {
+            list.push_back(token);
+        }
+        REQUIRE(list.size() == 3);
+        REQUIRE(list[0] == "");
+        REQUIRE(list[1] == "");
+        REQUIRE(list[2] == "");
+    }
+
+    SECTION("using standard algorithms")
+    {
+        text       = "one,two,three";
+        auto range = split_view(text, ',');
+        REQUIRE(std::distance(range.begin(), range.end()) == 3);
+        REQUIRE(*std::next(range.begin()) == "two");
+
+        auto it = std::find(range.begin(), range.end(), "two");
+        REQUIRE(it != range.end());
+        REQUIRE(it->data() == text.data() + 4);
+        REQUIRE(std::find(range.begin(), range.end(), "four") == range.end());
+    }
+}
+
+TEST_CASE("split a string with a multi-character separator", "[string]")
+{
+    SECTION("finding a separator")
+    {
+        REQUIRE(string_separator {"||"}.find("a||b") == 1);
+        REQUIRE(string_separator {"||"}.find("a|b|") == std::string::npos);
+        REQUIRE(string_separator {"\r\n"}.find("\r\r\n") == 1);
+        REQUIRE(string_separator {"::"}.find(":") == std::string::npos);
+        REQUIRE(string_separator {""}.find("abc") == std::string::npos);
+        REQUIRE(string_separator {"-"}.find("a-b") == 1);
+
+        // past the 16 positions compared at once and at the very end
+        std::string text(100, 'x');
+        text += "<sep>";
+        REQUIRE(string_separator {"<sep>"}.find(text) == 100);
+        REQUIRE(string_separator {"<sez>"}.find(text) == std::string::npos);
+
+        // long separators are found with a skip table
+        std::string long_sep(40, 'a');
+        long_sep.back() = 'b';
+        std::string long_text(200, 'a');
+        long_text += 'b';
+        REQUIRE(string_separator {long_sep}.find(long_text) == 161);
+        long_text.back() = 'a';
+        REQUIRE(
+            string_separator {long_sep}.find(long_text) == std::string::npos);
+    }
+
+    SECTION("tokenizing with a string_tokenizer")
+    {
+        string_separator sep {"||"};
+        string_tokenizer stok {"one||two|||three"};
+        REQUIRE(stok.next(sep) == "one");
+        REQUIRE(stok.next(sep) == "two");
+        REQUIRE(stok.next(sep) == "|three");
+        REQUIRE(stok.is_done());
+    }
+
+    SECTION("tokenizing empty tokens and a terminal separator")
+    {
+        string_separator sep {"\r\n"};
+        string_tokenizer stok {"\r\n\r\none\r\n"};
+        REQUIRE(stok.next(sep) == "");
+        REQUIRE(stok.next(sep) == "");
+        REQUIRE(stok.next(sep) == "one");
+        REQUIRE(!stok.is_done());
+        REQUIRE(stok.next(sep) == "");
+        REQUIRE(stok.is_done());
+    }
+
+    SECTION("tokenizing with split_view")
+    {
+        std::string       text {"std::chrono::seconds"};
+        string_view_array list;
+        for (auto token : split_view(text, string_separator {"::"})) {
+            list.push_back(token);
+        }
+        REQUIRE(list.size() == 3);
+        REQUIRE(list[0] == "std");
+        REQUIRE(list[1] == "chrono");
+        REQUIRE(list[2] == "seconds");
+
+        // a std::string_view is a list of separators, as with next()
+        auto range = split_view(text, std::string_view {":s"});
+        REQUIRE(std::distance(range.begin(), range.end()) == 8);
+    }
+
+    SECTION("tokenizing with split_view and a long separator")
+    {
+        // the skip table is shared, so copies (e.g., iterators) stay small
+        static_assert(sizeof(string_separator) <= 4 * sizeof(void*));
+
+        const std::string sep(40, '-');
+        const std::string text {"one" + sep + "two" + sep + "three"};
+        string_view_array list;
+        for (auto token : split_view(text, string_separator {sep})) {
+            list.push_back(token);
+        }
+        REQUIRE(list.size() == 3);
+        REQUIRE(list[0] == "one");
+        REQUIRE(list[1] == "two");
+        REQUIRE(list[2] == "three");
+    }
+}
+
+TEST_CASE("skip tokens with a string_tokenizer", "[string]")
+{
+    SECTION("skipping tokens")
+    {
+        string_tokenizer stok {"one,two,,four"};
+        REQUIRE(stok.skip(0, ',') == 0);
+        REQUIRE(stok.skip(2, ',') == 2);
+        REQUIRE(stok.head().empty());
+        REQUIRE(stok.tail() == ",four");
+        REQUIRE(stok.next(',') == "");
+        REQUIRE(stok.skip(5, ',') == 1);
+        REQUIRE(stok.is_done());
+        REQUIRE(stok.skip(1, ',') == 0);
+    }
+
+    SECTION("finding fields")
+    {
+        string_tokenizer stok {"one,two,,four,five"};
+        REQUIRE(stok.field(0, ',') == "one");
+        REQUIRE(stok.field(1, ',') == "");
+        REQUIRE(stok.field(1, ',') == "five");
+        REQUIRE(stok.is_done());
+        REQUIRE(stok.field(0, ',').empty());
+
+        string_tokenizer short_stok {"one,two"};
+        REQUIRE(short_stok.field(2, ',').empty());
+        REQUIRE(short_stok.is_done());
+    }
+
+    SECTION("skipping the same as calling next()")
+    {
+        // wide enough for the blocks counted at once
+        std::string line;
+        for (int i = 0; i < 300; ++i) {
+            line += std::to_string(i) + (i % 7 == 0 ? ",," : ",");
+        }
+
+        for (std::size_t k = 0; k < 400; k += 13) {
+            string_tokenizer expected {line};
+            for (std::size_t i = 0; i < k; ++i) {
+                expected.next(',');
+            }
+            string_tokenizer actual {line};
+            REQUIRE(actual.field(k, ',') == expected.next(','));
+            REQUIRE(actual.tail().data() == expected.tail().data());
+            REQUIRE(nth_field(line, ',', k) == actual.head());
+        }
+    }
+}
+
+TEST_CASE("find the n-th field of a string", "[string]")
+{
+    std::string text {"one,two,,four"};
+
+    REQUIRE(nth_field(text, ',', 0) == "one");
+    REQUIRE(nth_field(text, ',', 1) == "two");
+    REQUIRE(nth_field(text, ',', 2) == "");
+    REQUIRE(nth_field(text, ',', 3) == "four");
+    REQUIRE(nth_field(text, ',', 4).empty());
+    REQUIRE(nth_field("", ',', 0).empty());
+    REQUIRE(nth_field("one,", ',', 1).empty());
+}
+
+TEST_CASE("split a string into a reused array", "[string]")
+{
+    SECTION("into a string_view_array")
+    {
+        string_view_array list;
+        split_string("one,two,three", ',', list);
+        REQUIRE(list.size() == 3);
+        REQUIRE(list[2] == "three");
+
+        // the previous tokens are replaced and capacity is kept
+        auto capacity = list.capacity();
+        split_string(",", ',', list);
+        REQUIRE(list.size() == 2);
+        REQUIRE(list[0] == "");
+        REQUIRE(list[1] == "");
+        REQUIRE(list.capacity() == capacity);
+    }
+
+    SECTION("into a small_string_view_array")
+    {
+        small_string_view_array list;
+        split_string("one two", ' ', list);
+        REQUIRE(list.size() == 2);
+        REQUIRE(list[0] == "one");
+        REQUIRE(list[1] == "two");
+
+        // spill beyond the inline capacity
+        std::string text(39, ',');
+        split_string(text, ',', list);
+        REQUIRE(list.size() == 40);
+    }
+}